@@ -38,7 +38,7 @@ namespace Umati {
 
 						if (pSimpleNode->NodeClass == ModelOpcUa::NodeClass_t::Variable ||
 							pSimpleNode->NodeClass == ModelOpcUa::NodeClass_t::VariableType) {
-							auto value = getValue(pNode);
+							auto value = getValue(pSimpleNode);
 							if (nestAsChildren ||
 								(isBaseDataVariableType(pSimpleNode) && !pSimpleNode->ChildNodes.empty())) {
 								m_json["value"] = value;
@@ -17,7 +17,7 @@ namespace Umati {
 		namespace Converter {
 			class ModelToJson {
 			public:
-				typedef std::function<nlohmann::json(const std::shared_ptr<const ModelOpcUa::Node>)> getValue_t;
+				typedef std::function<nlohmann::json(const std::shared_ptr<const ModelOpcUa::SimpleNode> &)> getValue_t;
 
 				/**
 				* ModelToJson converts OpcUa nodes to json. ModelToJson calls itself recursively.
@@ -39,12 +39,12 @@ namespace Umati {
 					return m_json;
 				}
 
+				static bool isBaseDataVariableType(const std::shared_ptr<const ModelOpcUa::SimpleNode> &pSimpleNode);
+
 			protected:
 				static std::string nodeClassToString(ModelOpcUa::NodeClass_t nodeClass);
 
 				nlohmann::json m_json;
-
-				static bool isBaseDataVariableType(const std::shared_ptr<const ModelOpcUa::SimpleNode> &pSimpleNode);
 			};
 		}
 	}
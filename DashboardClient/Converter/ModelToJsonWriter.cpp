@@ -0,0 +1,310 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ModelToJsonWriter.hpp"
+#include "ModelToJson.hpp"
+#include <JsonFormat.hpp>
+#include <easylogging++.h>
+#include <map>
+
+namespace Umati {
+	namespace Dashboard {
+		namespace Converter {
+			namespace {
+				/// Thrown for documents that are only handled by ModelToJson
+				class UnsupportedException : public std::exception {
+				public:
+					const char *what() const noexcept override {
+						return "Document can not be streamed";
+					}
+				};
+
+				const std::string TypeDefinitionName = "$TypeDefinition";
+				const std::string TypeDefinitionKey = "\"$TypeDefinition\"";
+				const std::string PropertiesKey = "\"properties\"";
+				const std::string ValueKey = "\"value\"";
+
+				/// Separator, indentation and key of an object member, as written by nlohmann::json::dump
+				void beginMember(bool first, int indent, const std::string &key, std::string &out) {
+					if (!first) {
+						out += ',';
+					}
+					if (Util::JsonFormat::Compact) {
+						out += key;
+						out += ':';
+						return;
+					}
+					out += '\n';
+					out.append(indent + 2, ' ');
+					out += key;
+					out += ": ";
+				}
+
+				void endObject(int indent, std::string &out) {
+					if (!Util::JsonFormat::Compact) {
+						out += '\n';
+						out.append(indent, ' ');
+					}
+					out += '}';
+				}
+
+				/// Fragments are serialized at indent 0, nested lines are shifted to the current indent
+				void appendFragment(const std::string &fragment, int indent, std::string &out) {
+					if (fragment.empty()) {
+						throw UnsupportedException();
+					}
+					if (indent == 0 || Util::JsonFormat::Compact) {
+						out += fragment;
+						return;
+					}
+					for (const char c : fragment) {
+						out += c;
+						if (c == '\n') {
+							out.append(indent, ' ');
+						}
+					}
+				}
+
+				void writeTypeDefinitionOnly(const std::string &typeDefinition, int indent, std::string &out) {
+					out += '{';
+					beginMember(true, indent, TypeDefinitionKey, out);
+					out += typeDefinition;
+					endObject(indent, out);
+				}
+			}
+
+			ModelToJsonWriter::ModelToJsonWriter(const std::shared_ptr<const ModelOpcUa::Node> &pNode) {
+				try {
+					m_root = createNode(pNode);
+				}
+				catch (const nlohmann::json::exception &ex) {
+					// e.g. a BrowseName that is no valid UTF-8, ModelToJson reports it on every publish
+					LOG(WARNING) << "Document can not be streamed: " << ex.what();
+				}
+			}
+
+			bool ModelToJsonWriter::write(const getFragment_t &getFragment, std::string &out) const {
+				out.clear();
+				if (!m_root) {
+					return false;
+				}
+				try {
+					if (!writeNode(*m_root, nullptr, getFragment, 0, out)) {
+						out = "null";
+					}
+					return true;
+				}
+				catch (const UnsupportedException &) {
+					out.clear();
+					return false;
+				}
+			}
+
+			std::shared_ptr<const std::string> ModelToJsonWriter::fragment(const nlohmann::json &value) {
+				if (value.is_null()) {
+					return nullptr;
+				}
+				try {
+					return std::make_shared<const std::string>(Util::JsonFormat::Dump(value));
+				}
+				catch (const nlohmann::json::exception &) {
+					// Serialized again by ModelToJson, which reports the error
+					return std::make_shared<const std::string>();
+				}
+			}
+
+			ModelToJsonWriter::NodePtr_t
+			ModelToJsonWriter::createNode(const std::shared_ptr<const ModelOpcUa::Node> &pNode) {
+				auto node = std::make_shared<Node_t>();
+				switch (pNode->ModellingRule) {
+					case ModelOpcUa::ModellingRule_t::Mandatory:
+					case ModelOpcUa::ModellingRule_t::Optional: {
+						auto pSimpleNode = std::dynamic_pointer_cast<const ModelOpcUa::SimpleNode>(pNode);
+						if (!pSimpleNode) {
+							break;
+						}
+						node->Kind = Node_t::Kind_t::Simple;
+						node->ValueSlot = pSimpleNode->ValueSlot;
+						node->IsVariable = pSimpleNode->NodeClass == ModelOpcUa::NodeClass_t::Variable ||
+										   pSimpleNode->NodeClass == ModelOpcUa::NodeClass_t::VariableType;
+						node->IsBaseDataVariable = ModelToJson::isBaseDataVariableType(pSimpleNode);
+						node->IsWrapped = node->IsBaseDataVariable && !pSimpleNode->ChildNodes.empty();
+
+						// std::map orders the groups like the keys of nlohmann::json
+						std::map<std::string, ChildGroup_t> children;
+						for (const auto &pChild : pSimpleNode->ChildNodes) {
+							children[pChild->SpecifiedBrowseName.Name].Candidates.push_back(createNode(pChild));
+						}
+						for (auto &child : children) {
+							child.second.Name = child.first;
+							child.second.Key = serializeString(child.first);
+							node->Children.push_back(std::move(child.second));
+						}
+						break;
+					}
+					case ModelOpcUa::ModellingRule_t::MandatoryPlaceholder:
+					case ModelOpcUa::ModellingRule_t::OptionalPlaceholder: {
+						auto pPlaceholderNode = std::dynamic_pointer_cast<const ModelOpcUa::PlaceholderNode>(pNode);
+						if (!pPlaceholderNode) {
+							break;
+						}
+						node->Kind = Node_t::Kind_t::Placeholder;
+
+						// Later elements with the same BrowseName replace earlier ones, like in ModelToJson
+						std::map<std::string, PlaceholderElement_t> elements;
+						for (const auto &placeholderElement : pPlaceholderNode->getInstances()) {
+							PlaceholderElement_t element;
+							element.Key = serializeString(placeholderElement.BrowseName.Name);
+							element.Node = createNode(placeholderElement.pNode);
+							element.TypeDefinition = serializeString(
+									static_cast<std::string>(placeholderElement.TypeDefinition));
+							elements[placeholderElement.BrowseName.Name] = std::move(element);
+						}
+						for (auto &element : elements) {
+							node->Elements.push_back(std::move(element.second));
+						}
+						break;
+					}
+					default:
+						break;
+				}
+				return node;
+			}
+
+			std::string ModelToJsonWriter::serializeString(const std::string &value) {
+				return nlohmann::json(value).dump();
+			}
+
+			bool ModelToJsonWriter::writeNode(const Node_t &node, const std::string *pTypeDefinition,
+											  const getFragment_t &getFragment, int indent, std::string &out) {
+				const auto start = out.size();
+				switch (node.Kind) {
+					case Node_t::Kind_t::Simple: {
+						if (node.IsWrapped) {
+							out += '{';
+							bool first = true;
+							if (pTypeDefinition) {
+								beginMember(first, indent, TypeDefinitionKey, out);
+								out += *pTypeDefinition;
+								first = false;
+							}
+							const auto propertiesStart = out.size();
+							beginMember(first, indent, PropertiesKey, out);
+							if (writeChildren(node, nullptr, getFragment, indent + 2, out)) {
+								first = false;
+							} else {
+								out.resize(propertiesStart);
+							}
+							if (node.IsVariable) {
+								beginMember(first, indent, ValueKey, out);
+								auto pFragment = getFragment(node.ValueSlot);
+								if (pFragment) {
+									appendFragment(*pFragment, indent + 2, out);
+								} else {
+									out += "null";
+								}
+								first = false;
+							}
+							if (first) {
+								out.resize(start);
+								break;
+							}
+							endObject(indent, out);
+							return true;
+						}
+
+						if (writeChildren(node, pTypeDefinition, getFragment, indent, out)) {
+							return true;
+						}
+						if (node.IsVariable) {
+							auto pFragment = getFragment(node.ValueSlot);
+							if (pFragment) {
+								// ModelToJson adds the TypeDefinition to the value itself
+								if (pTypeDefinition) {
+									throw UnsupportedException();
+								}
+								appendFragment(*pFragment, indent, out);
+								return true;
+							}
+						}
+						break;
+					}
+					case Node_t::Kind_t::Placeholder: {
+						if (pTypeDefinition) {
+							throw UnsupportedException();
+						}
+						if (node.Elements.empty()) {
+							break;
+						}
+						out += '{';
+						bool first = true;
+						for (const auto &element : node.Elements) {
+							beginMember(first, indent, element.Key, out);
+							writeNode(*element.Node, &element.TypeDefinition, getFragment, indent + 2, out);
+							first = false;
+						}
+						endObject(indent, out);
+						return true;
+					}
+					case Node_t::Kind_t::Invalid:
+						break;
+				}
+
+				// Null node, ModelToJson turns it into an object if a TypeDefinition is added
+				if (pTypeDefinition) {
+					writeTypeDefinitionOnly(*pTypeDefinition, indent, out);
+					return true;
+				}
+				return false;
+			}
+
+			bool ModelToJsonWriter::writeChildren(const Node_t &node, const std::string *pTypeDefinition,
+												  const getFragment_t &getFragment, int indent, std::string &out) {
+				const auto start = out.size();
+				out += '{';
+				bool first = true;
+				bool childWritten = false;
+				bool typeDefinitionWritten = pTypeDefinition == nullptr;
+				for (const auto &group : node.Children) {
+					if (!typeDefinitionWritten && TypeDefinitionName <= group.Name) {
+						if (TypeDefinitionName == group.Name) {
+							throw UnsupportedException();
+						}
+						beginMember(first, indent, TypeDefinitionKey, out);
+						out += *pTypeDefinition;
+						first = false;
+						typeDefinitionWritten = true;
+					}
+
+					const auto memberStart = out.size();
+					beginMember(first, indent, group.Key, out);
+					bool written = false;
+					// The last child that is not null wins, like the assignments in ModelToJson
+					for (auto it = group.Candidates.rbegin(); it != group.Candidates.rend() && !written; ++it) {
+						written = writeNode(**it, nullptr, getFragment, indent + 2, out);
+					}
+					if (written) {
+						first = false;
+						childWritten = true;
+					} else {
+						out.resize(memberStart);
+					}
+				}
+
+				// Without children ModelToJson uses the value of the node
+				if (!childWritten) {
+					out.resize(start);
+					return false;
+				}
+				if (!typeDefinitionWritten) {
+					beginMember(first, indent, TypeDefinitionKey, out);
+					out += *pTypeDefinition;
+				}
+				endObject(indent, out);
+				return true;
+			}
+		}
+	}
+}
@@ -0,0 +1,88 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <ModelOpcUa/ModelInstance.hpp>
+#include <nlohmann/json.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Umati {
+	namespace Dashboard {
+		namespace Converter {
+			/**
+			* Streams the document of ModelToJson (with default options) serialized by Util::JsonFormat::Dump into a string,
+			* without building the document. Values are passed as serialized fragments, see fragment().
+			* The layout of the tree (sorted keys, ignored duplicates) is computed once by the constructor,
+			* the node tree must not change afterwards.
+			*/
+			class ModelToJsonWriter {
+			public:
+				/// Returns the fragment of SimpleNode::ValueSlot, nullptr for a null value
+				typedef std::function<std::shared_ptr<const std::string>(std::size_t valueSlot)> getFragment_t;
+
+				explicit ModelToJsonWriter(const std::shared_ptr<const ModelOpcUa::Node> &pNode);
+
+				/// Replaces the content of out, the capacity of out is reused
+				/// \return false if the document can not be streamed (e.g. a placeholder element with a scalar value),
+				/// ModelToJson has to be used then
+				bool write(const getFragment_t &getFragment, std::string &out) const;
+
+				/// Serialized value as expected by write, nullptr for null and an empty string if value can not be serialized.
+				/// Depends on Util::JsonFormat::Compact like the output of write.
+				static std::shared_ptr<const std::string> fragment(const nlohmann::json &value);
+
+			protected:
+				struct Node_t;
+				typedef std::shared_ptr<const Node_t> NodePtr_t;
+
+				/// Children with the same BrowseName, the last one that is not null is written
+				struct ChildGroup_t {
+					std::string Name;
+					/// Serialized name including quotes
+					std::string Key;
+					std::vector<NodePtr_t> Candidates;
+				};
+
+				struct PlaceholderElement_t {
+					std::string Key;
+					NodePtr_t Node;
+					/// Serialized TypeDefinition including quotes
+					std::string TypeDefinition;
+				};
+
+				struct Node_t {
+					enum class Kind_t { Simple, Placeholder, Invalid } Kind = Kind_t::Invalid;
+					std::size_t ValueSlot = ModelOpcUa::SimpleNode::NoValueSlot;
+					bool IsVariable = false;
+					bool IsBaseDataVariable = false;
+					/// Written as object with "properties" (and "value" for variables)
+					bool IsWrapped = false;
+					/// Sorted by Name
+					std::vector<ChildGroup_t> Children;
+					/// Sorted by Key, only the last element of each BrowseName
+					std::vector<PlaceholderElement_t> Elements;
+				};
+
+				static NodePtr_t createNode(const std::shared_ptr<const ModelOpcUa::Node> &pNode);
+
+				static std::string serializeString(const std::string &value);
+
+				/// Writes node at the given indent, pTypeDefinition is added as "$TypeDefinition" member if not nullptr
+				/// \return false if the node is null, nothing is written then
+				static bool writeNode(const Node_t &node, const std::string *pTypeDefinition, const getFragment_t &getFragment,
+									  int indent, std::string &out);
+
+				static bool writeChildren(const Node_t &node, const std::string *pTypeDefinition, const getFragment_t &getFragment,
+										  int indent, std::string &out);
+
+				NodePtr_t m_root;
+			};
+		}
+	}
+}
@@ -13,6 +13,7 @@
 #include <easylogging++.h>
 #include <Exceptions/OpcUaException.hpp>
 #include "Converter/ModelToJson.hpp"
+#include <JsonFormat.hpp>
 
 namespace Umati
 {
@@ -23,8 +24,10 @@ namespace Umati
 		DashboardClient::DashboardClient(
 			std::shared_ptr<IDashboardDataClient> pDashboardDataClient,
 			std::shared_ptr<IPublisher> pPublisher,
-			std::shared_ptr<OpcUaTypeReader> pTypeReader)
-			: m_pDashboardDataClient(pDashboardDataClient), m_pPublisher(pPublisher), m_pTypeReader(pTypeReader)
+			std::shared_ptr<OpcUaTypeReader> pTypeReader,
+			std::function<void()> onValueChanged)
+			: m_pDashboardDataClient(pDashboardDataClient), m_pPublisher(pPublisher), m_pTypeReader(pTypeReader),
+			  m_onValueChanged(std::move(onValueChanged))
 		{
 		}
 
@@ -37,7 +40,8 @@ namespace Umati
 			const ModelOpcUa::NodeId_t &startNodeId,
 			const std::shared_ptr<ModelOpcUa::StructureNode> &pTypeDefinition,
 			const std::string &channel,
-			const std::string &onlineChannel
+			const std::string &onlineChannel,
+			const std::string &patchChannel
 			)
 		{
 			try
@@ -46,9 +50,11 @@ namespace Umati
 					startNodeId,
 					pTypeDefinition,
 					channel,
-					onlineChannel);
+					onlineChannel,
+					patchChannel);
 				LOG(INFO) << "DataSetStorage prepared for " << channel;
-				subscribeValues(pDataSetStorage->node, pDataSetStorage->values, pDataSetStorage->values_mutex);
+				subscribeValues(pDataSetStorage->node, *pDataSetStorage);
+				subscribePending();
 				LOG(INFO) << "Values subscribed for  " << channel;
 				std::lock_guard<std::recursive_mutex> l(m_dataSetMutex);
 				m_dataSets.push_back(pDataSetStorage);
@@ -73,13 +79,19 @@ namespace Umati
 		DashboardClient::prepareDataSetStorage(const ModelOpcUa::NodeId_t &startNodeId,
 											   const std::shared_ptr<ModelOpcUa::StructureNode> &pTypeDefinition,
 											   const std::string &channel,
-											   const std::string &onlineChannel)
+											   const std::string &onlineChannel,
+											   const std::string &patchChannel)
 		{
 			auto pDataSetStorage = std::make_shared<DataSetStorage_t>();
 			pDataSetStorage->startNodeId = startNodeId;
 			pDataSetStorage->channel = channel;
 			pDataSetStorage->onlineChannel = onlineChannel;
+			pDataSetStorage->patchChannel = patchChannel;
+			m_nextValueSlot = 0;
 			pDataSetStorage->node = TransformToNodeIds(startNodeId, pTypeDefinition);
+			pDataSetStorage->values.resize(m_nextValueSlot);
+			pDataSetStorage->fragments.resize(m_nextValueSlot);
+			pDataSetStorage->writer = std::make_shared<const Converter::ModelToJsonWriter>(pDataSetStorage->node);
 			return pDataSetStorage;
 		}
 
@@ -88,19 +100,60 @@ namespace Umati
 			std::lock_guard<std::recursive_mutex> l(m_dataSetMutex);
 			for (auto &pDataSetStorage : m_dataSets)
 			{
-				std::string jsonPayload = getJson(pDataSetStorage);
-				if (!jsonPayload.empty() && jsonPayload != "null")
+				LastMessage_t &lastMessage = m_latestMessages[pDataSetStorage->channel];
+				time_t now;
+				time(&now);
+				const bool republishDue = difftime(now, lastMessage.lastSent) > 10;
+
+				// Skip the tree walk and serialization if no value changed since the last publish
+				const auto generation = pDataSetStorage->generation.load();
+				if (generation == pDataSetStorage->publishedGeneration)
 				{
-					LastMessage_t &lastMessage = m_latestMessages[pDataSetStorage->channel];
-
-					time_t now;
-					time(&now);
+					if (!lastMessage.payload.empty())
+					{
+						if (republishDue)
+						{
+							m_pPublisher->Publish(pDataSetStorage->channel, lastMessage.payload);
+							lastMessage.lastSent = now;
+						}
+						m_pPublisher->Publish(pDataSetStorage->onlineChannel, "1");
+					}
+					continue;
+				}
+				pDataSetStorage->publishedGeneration = generation;
 
-					if (jsonPayload != lastMessage.payload || difftime(now, lastMessage.lastSent) > 10)
+				// Merge patches are computed from the document, all other payloads are streamed from the fragments
+				nlohmann::json document;
+				std::string jsonPayload;
+				if (pDataSetStorage->patchChannel.empty() && pDataSetStorage->writer &&
+					pDataSetStorage->writer->write(getFragmentCallback(pDataSetStorage), pDataSetStorage->buffer))
+				{
+					jsonPayload.swap(pDataSetStorage->buffer);
+				}
+				else
+				{
+					document = getJson(pDataSetStorage);
+					jsonPayload = Util::JsonFormat::Dump(document);
+				}
+				if (!jsonPayload.empty() && jsonPayload != "null")
+				{
+					if (jsonPayload != lastMessage.payload || republishDue)
 					{
-						m_pPublisher->Publish(pDataSetStorage->channel, jsonPayload);
-						lastMessage.payload = jsonPayload;
-						lastMessage.lastSent = now;
+						// Full snapshots are still sent for new documents and at the republish cadence
+						if (!pDataSetStorage->patchChannel.empty() && !republishDue && !lastMessage.payload.empty())
+						{
+							m_pPublisher->Publish(pDataSetStorage->patchChannel,
+												  Util::JsonFormat::Dump(createMergePatch(lastMessage.document, document)));
+						}
+						else
+						{
+							m_pPublisher->Publish(pDataSetStorage->channel, jsonPayload);
+							lastMessage.lastSent = now;
+						}
+						// Keep the old payload's capacity for the next streamed payload
+						jsonPayload.swap(lastMessage.payload);
+						pDataSetStorage->buffer.swap(jsonPayload);
+						lastMessage.document = std::move(document);
 					}
 					m_pPublisher->Publish(pDataSetStorage->onlineChannel, "1");
 				}
@@ -129,6 +182,7 @@ namespace Umati
 				
 			}
 			m_subscribedValues.clear();
+			m_subscribedNodeIds.clear();
 
 			m_pDashboardDataClient->Unsubscribe(monItemIds, clientHandles);
 
@@ -137,21 +191,68 @@ namespace Umati
 			
 		}
 
-		std::string DashboardClient::getJson(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage)
+		nlohmann::json DashboardClient::getJson(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage)
 		{
 			auto getValueCallback = [pDataSetStorage](
-										const std::shared_ptr<const ModelOpcUa::Node> &pNode) -> nlohmann::json {
-				std::unique_lock<decltype(pDataSetStorage->values_mutex)> ul(pDataSetStorage->values_mutex);
-				auto it = pDataSetStorage->values.find(pNode);
-				if (it == pDataSetStorage->values.end())
+										const std::shared_ptr<const ModelOpcUa::SimpleNode> &pNode) -> nlohmann::json {
+				if (pNode->ValueSlot >= pDataSetStorage->values.size())
 				{
 					// LOG(INFO) << "Couldn't write value for " << pNode->SpecifiedBrowseName.Name << " | " << pNode->SpecifiedTypeNodeId.Uri << ";" << pNode->SpecifiedTypeNodeId.Id;
 					return nullptr;
 				}
-				return it->second;
+				auto pValue = std::atomic_load(&pDataSetStorage->values[pNode->ValueSlot]);
+				if (!pValue)
+				{
+					return nullptr;
+				}
+				return *pValue;
 			};
 
-			return Converter::ModelToJson(pDataSetStorage->node, getValueCallback).getJson().dump(2);
+			return Converter::ModelToJson(pDataSetStorage->node, getValueCallback).getJson();
+		}
+
+		Converter::ModelToJsonWriter::getFragment_t
+		DashboardClient::getFragmentCallback(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage)
+		{
+			return [pDataSetStorage](std::size_t valueSlot) -> std::shared_ptr<const std::string> {
+				if (valueSlot >= pDataSetStorage->fragments.size())
+				{
+					return nullptr;
+				}
+				return std::atomic_load(&pDataSetStorage->fragments[valueSlot]);
+			};
+		}
+
+		nlohmann::json DashboardClient::createMergePatch(const nlohmann::json &source, const nlohmann::json &target)
+		{
+			if (!source.is_object() || !target.is_object())
+			{
+				return target;
+			}
+
+			// A null member removes the member in a merge patch, so null values in target
+			// are not distinguishable from removed members for the receiver.
+			nlohmann::json patch = nlohmann::json::object();
+			for (auto it = source.begin(); it != source.end(); ++it)
+			{
+				if (target.find(it.key()) == target.end())
+				{
+					patch[it.key()] = nullptr;
+				}
+			}
+			for (auto it = target.begin(); it != target.end(); ++it)
+			{
+				auto itSource = source.find(it.key());
+				if (itSource == source.end())
+				{
+					patch[it.key()] = it.value();
+				}
+				else if (*itSource != it.value())
+				{
+					patch[it.key()] = createMergePatch(*itSource, it.value());
+				}
+			}
+			return patch;
 		}
 
 		std::shared_ptr<const ModelOpcUa::SimpleNode> DashboardClient::TransformToNodeIds(
@@ -161,6 +262,35 @@ namespace Umati
 			auto ret = browsedNodes.insert(startNode);
 			std::list<std::shared_ptr<const ModelOpcUa::Node>> foundChildNodes;
 			if(ret.second==true) {
+				// Resolve all Optional and Mandatory children of this level with a single request
+				std::vector<ModelOpcUa::QualifiedName_t> childBrowseNames;
+				for (auto &pChild : *pTypeDefinition->SpecifiedChildNodes)
+				{
+					if (pChild->ModellingRule == ModelOpcUa::ModellingRule_t::Optional ||
+						pChild->ModellingRule == ModelOpcUa::ModellingRule_t::Mandatory)
+					{
+						childBrowseNames.push_back(pChild->SpecifiedBrowseName);
+					}
+				}
+				std::vector<IDashboardDataClient::TranslateBrowsePathResult_t> translatedChildren;
+				try
+				{
+					// Not holding the client lock while waiting, machines built in parallel have their requests in flight together
+					auto translation = m_pDashboardDataClient->TranslateAsync(startNode, childBrowseNames);
+					translatedChildren = IDashboardDataClient::waitForResult(translation);
+				}
+				catch (std::exception &ex)
+				{
+					// A failing request must not invalidate all children, resolve each child on its own,
+					// so only the failing children are subject to the Optional/Mandatory rules
+					LOG(WARNING) << "Translating " << childBrowseNames.size() << " browse paths of "
+								 << static_cast<std::string>(startNode) << " failed: " << ex.what()
+								 << ", translating them one by one";
+					translatedChildren = m_pDashboardDataClient->IDashboardDataClient::TranslateBrowsePathsToNodeIds(
+						startNode, childBrowseNames);
+				}
+				auto translatedChild = translatedChildren.begin();
+
 				for (auto &pChild : *pTypeDefinition->SpecifiedChildNodes)
 				{
 					switch (pChild->ModellingRule)
@@ -171,7 +301,8 @@ namespace Umati
 						bool should_continue = OptionalAndMandatoryTransformToNodeId(
 							startNode,
 							foundChildNodes,
-							pChild);
+							pChild,
+							*translatedChild++);
 						if (should_continue)
 						{
 							continue;
@@ -210,6 +341,10 @@ namespace Umati
 				foundChildNodes);
 
 			pNode->ofBaseDataVariableType = pTypeDefinition->ofBaseDataVariableType;
+			if (isMandatoryOrOptionalVariable(pNode))
+			{
+				pNode->ValueSlot = m_nextValueSlot++;
+			}
 			return pNode;
 		}
 
@@ -235,12 +370,22 @@ namespace Umati
 		 */
 		bool DashboardClient::OptionalAndMandatoryTransformToNodeId(const ModelOpcUa::NodeId_t &startNode,
 																	std::list<std::shared_ptr<const ModelOpcUa::Node>> &foundChildNodes,
-																	const std::shared_ptr<ModelOpcUa::StructureNode> &pChild)
+																	const std::shared_ptr<ModelOpcUa::StructureNode> &pChild,
+																	const IDashboardDataClient::TranslateBrowsePathResult_t &translatedChild)
 		{
+			if (!translatedChild.Error.empty())
+			{
+				if (pChild->ModellingRule != ModelOpcUa::ModellingRule_t::Optional)
+				{
+					std::string err = GetOptionalAndMandatoryTransformToNodeIdError(startNode, pChild->SpecifiedBrowseName, translatedChild.Error.c_str());
+					LogOptionalAndMandatoryTransformToNodeIdError(startNode, pChild->SpecifiedBrowseName, translatedChild.Error.c_str());
+					throw MachineObserver::Exceptions::MachineInvalidChildException(err, true);
+				}
+				return false;
+			}
 			try
 			{
-				auto childNodeId = m_pDashboardDataClient->TranslateBrowsePathToNodeId(startNode,
-																					   pChild->SpecifiedBrowseName);
+				const auto &childNodeId = translatedChild.TargetNodeId;
 				if (childNodeId.isNull())
 				{
 					TransformToNodeIdNodeNotFoundLog(startNode, pChild);
@@ -357,11 +502,10 @@ namespace Umati
 						LOG(INFO) << "Updated TypeDefinition of " << browseResult.BrowseName.Name << " to " << browseResult.TypeDefinition 
 								  << " because the node implements an interface";				
 				}
-				auto possibleType = m_pTypeReader->m_typeMap->find(browseResult.TypeDefinition);  // use subtype
-				if (possibleType != m_pTypeReader->m_typeMap->end())
+				auto sharedPossibleType = m_pTypeReader->findTypeStructureNode(browseResult.TypeDefinition);  // use subtype
+				if (sharedPossibleType)
 				{
 					// LOG(INFO) << "Found type for " << typeName;
-					auto sharedPossibleType = possibleType->second;
 					ModelOpcUa::PlaceholderElement plElement;
 					plElement.BrowseName = browseResult.BrowseName;
 					plElement.pNode = TransformToNodeIds(browseResult.NodeId, sharedPossibleType);
@@ -380,23 +524,21 @@ namespace Umati
 
 		void DashboardClient::subscribeValues(
 			const std::shared_ptr<const ModelOpcUa::SimpleNode> pNode,
-			std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-			std::mutex &valueMap_mutex)
+			DataSetStorage_t &dataSetStorage)
 		{
 			// LOG(INFO) << "subscribeValues "   << pNode->NodeId.Uri << ";" << pNode->NodeId.Id;
 
 			// Only Mandatory/Optional variables
 			if (isMandatoryOrOptionalVariable(pNode))
 			{
-				subscribeValue(pNode, valueMap, valueMap_mutex);
+				subscribeValue(pNode, dataSetStorage);
 			}
 
-			handleSubscribeChildNodes(pNode, valueMap, valueMap_mutex);
+			handleSubscribeChildNodes(pNode, dataSetStorage);
 		}
 
 		void DashboardClient::handleSubscribeChildNodes(const std::shared_ptr<const ModelOpcUa::SimpleNode> &pNode,
-														std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-														std::mutex &valueMap_mutex)
+														DataSetStorage_t &dataSetStorage)
 		{
 			// LOG(INFO) << "handleSubscribeChildNodes "   << pNode->NodeId.Uri << ";" << pNode->NodeId.Id;
 			if (pNode->ChildNodes.size() == 0)
@@ -410,13 +552,13 @@ namespace Umati
 				case ModelOpcUa::Mandatory:
 				case ModelOpcUa::Optional:
 				{
-					handleSubscribeChildNode(pChildNode, valueMap, valueMap_mutex);
+					handleSubscribeChildNode(pChildNode, dataSetStorage);
 					break;
 				}
 				case ModelOpcUa::MandatoryPlaceholder:
 				case ModelOpcUa::OptionalPlaceholder:
 				{
-					handleSubscribePlaceholderChildNode(pChildNode, valueMap, valueMap_mutex);
+					handleSubscribePlaceholderChildNode(pChildNode, dataSetStorage);
 					break;
 				}
 				default:
@@ -429,8 +571,7 @@ namespace Umati
 		}
 
 		void DashboardClient::handleSubscribeChildNode(const std::shared_ptr<const ModelOpcUa::Node> &pChildNode,
-													   std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-													   std::mutex &valueMap_mutex)
+													   DataSetStorage_t &dataSetStorage)
 		{
 			// LOG(INFO) << "handleSubscribeChildNode " <<  pChildNode->SpecifiedBrowseName.Uri << ";" <<  pChildNode->SpecifiedBrowseName.Name;
 
@@ -441,13 +582,12 @@ namespace Umati
 				return;
 			}
 			// recursive call
-			subscribeValues(pSimpleChild, valueMap, valueMap_mutex);
+			subscribeValues(pSimpleChild, dataSetStorage);
 		}
 
 		void
 		DashboardClient::handleSubscribePlaceholderChildNode(const std::shared_ptr<const ModelOpcUa::Node> &pChildNode,
-															 std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-															 std::mutex &valueMap_mutex)
+															 DataSetStorage_t &dataSetStorage)
 		{
 			// LOG(INFO) << "handleSubscribePlaceholderChildNode " << pChildNode->SpecifiedBrowseName.Uri << ";" << pChildNode->SpecifiedBrowseName.Name;
 			auto pPlaceholderChild = std::dynamic_pointer_cast<const ModelOpcUa::PlaceholderNode>(pChildNode);
@@ -462,38 +602,68 @@ namespace Umati
 			for (const auto &pPlaceholderElement : placeholderElements)
 			{
 				// recursive call
-				subscribeValues(pPlaceholderElement.pNode, valueMap, valueMap_mutex);
+				subscribeValues(pPlaceholderElement.pNode, dataSetStorage);
 			}
 		}
 
 		void DashboardClient::subscribeValue(const std::shared_ptr<const ModelOpcUa::SimpleNode> &pNode,
-											 std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-											 std::mutex &valueMap_mutex
-											 )
+											 DataSetStorage_t &dataSetStorage)
 		{ /**
-                                             * Creates a lambda function which gets pNode as a copy and valueMap as a reference from this function,
+                                             * Creates a lambda function which gets the value slot of pNode as a copy and dataSetStorage as a reference from this function,
                                              * the input parameters of the lambda function is the nlohmann::json value and the body updates the value
-                                             * at position pNode with the received json value.
+                                             * in the slot of pNode with the received json value and marks the data set as changed.
                                              */
 			// LOG(INFO) << "SubscribeValue " << pNode->SpecifiedBrowseName.Uri << ";" << pNode->SpecifiedBrowseName.Name << " | " << pNode->NodeId.Uri << ";" << pNode->NodeId.Id;
 
-			auto callback = [pNode, &valueMap, &valueMap_mutex](nlohmann::json value) {
-					std::unique_lock<std::remove_reference<decltype(valueMap_mutex)>::type>(valueMap_mutex);
-					valueMap[pNode] = value;
+			auto callback = [valueSlot = pNode->ValueSlot, &dataSetStorage, onValueChanged = m_onValueChanged](nlohmann::json value) {
+					std::atomic_store(&dataSetStorage.fragments[valueSlot], Converter::ModelToJsonWriter::fragment(value));
+					std::atomic_store(&dataSetStorage.values[valueSlot], std::make_shared<const nlohmann::json>(std::move(value)));
+					++dataSetStorage.generation;
+					if (onValueChanged)
+					{
+						onValueChanged();
+					}
 			};
+			if (!m_subscribedNodeIds.insert(pNode->NodeId).second)
+			{
+				return;
+			}
+			m_pendingSubscriptions.nodeIds.push_back(pNode->NodeId);
+			m_pendingSubscriptions.callbacks.push_back(callback);
+		}
+
+		void DashboardClient::subscribePending()
+		{
+			PendingSubscriptions_t pending;
+			std::swap(pending, m_pendingSubscriptions);
+			if (pending.nodeIds.empty())
+			{
+				return;
+			}
+
+			std::vector<std::shared_ptr<IDashboardDataClient::ValueSubscriptionHandle>> subscribedValues;
 			try
 			{
-				for(auto value : m_subscribedValues){
-					if(value && value.get()->getNodeId() == pNode.get()->NodeId)
-					return;
-				}
-				auto subscribedValue = m_pDashboardDataClient->Subscribe(pNode->NodeId, callback);
-				m_subscribedValues.push_back(subscribedValue);
+				subscribedValues = m_pDashboardDataClient->SubscribeMany(pending.nodeIds, pending.callbacks);
 			}
 			catch (std::exception &ex)
 			{
 				LOG(ERROR) << "Subscribe thrown an error: " << ex.what();
 			}
+			subscribedValues.resize(pending.nodeIds.size());
+
+			for (std::size_t i = 0; i < pending.nodeIds.size(); ++i)
+			{
+				if (subscribedValues[i])
+				{
+					m_subscribedValues.push_back(subscribedValues[i]);
+				}
+				else
+				{
+					// Allow a later data set to retry the subscription
+					m_subscribedNodeIds.erase(pending.nodeIds[i]);
+				}
+			}
 		}
 
 		bool
@@ -12,9 +12,13 @@
 #include "IDashboardDataClient.hpp"
 #include "OpcUaTypeReader.hpp"
 #include "IPublisher.hpp"
+#include "Converter/ModelToJsonWriter.hpp"
+#include <ModelOpcUa/InternedNodeId.hpp>
 #include <ModelOpcUa/ModelInstance.hpp>
+#include <atomic>
 #include <map>
 #include <set>
+#include <unordered_set>
 #include <mutex>
 namespace Umati {
 
@@ -40,13 +44,15 @@ namespace Umati {
 		public:
 			DashboardClient(std::shared_ptr<IDashboardDataClient> pDashboardDataClient,
 							std::shared_ptr<IPublisher> pPublisher,
-							std::shared_ptr<OpcUaTypeReader> pTypeReader);
+							std::shared_ptr<OpcUaTypeReader> pTypeReader,
+							std::function<void()> onValueChanged = nullptr);
 
 			void addDataSet(
 					const ModelOpcUa::NodeId_t &startNodeId,
 					const std::shared_ptr<ModelOpcUa::StructureNode> &pTypeDefinition,
 					const std::string &channel,
-					const std::string &onlineChannel);
+					const std::string &onlineChannel,
+					const std::string &patchChannel = std::string());
 
 			void Publish();
 
@@ -57,6 +63,8 @@ namespace Umati {
 
 			struct LastMessage_t {
 				std::string payload;
+				/// Document of payload, base for the next merge patch
+				nlohmann::json document;
 				time_t lastSent;
 			};
 
@@ -64,12 +72,32 @@ namespace Umati {
 				ModelOpcUa::NodeId_t startNodeId;
 				std::string channel;
 				std::string onlineChannel;
+				/// Empty if no merge patches are published
+				std::string patchChannel;
 				std::shared_ptr<const ModelOpcUa::SimpleNode> node;
-				std::mutex values_mutex;
-				std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> values;
+				/// Indexed by SimpleNode::ValueSlot, the vector is sized before subscribing and never resized.
+				/// Elements are only accessed with std::atomic_load/std::atomic_store, so the data change
+				/// callbacks never wait for a running serialization.
+				std::vector<std::shared_ptr<const nlohmann::json>> values;
+				/// Serialized values, see Converter::ModelToJsonWriter::fragment. Same slots and access as values.
+				std::vector<std::shared_ptr<const std::string>> fragments;
+				/// Streams the payload from fragments, created once the node tree is complete
+				std::shared_ptr<const Converter::ModelToJsonWriter> writer;
+				/// Output of writer, only accessed by Publish so the capacity is reused
+				std::string buffer;
+				/// Incremented on every value change
+				std::atomic<std::uint64_t> generation = {1};
+				/// Generation of the last serialized payload, only accessed by Publish
+				std::uint64_t publishedGeneration = 0;
 			};
 
-			static std::string getJson(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage);
+			static nlohmann::json getJson(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage);
+
+			static Converter::ModelToJsonWriter::getFragment_t
+			getFragmentCallback(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage);
+
+			/// Create a RFC 7386 merge patch that transforms source into target
+			static nlohmann::json createMergePatch(const nlohmann::json &source, const nlohmann::json &target);
 
 			std::shared_ptr<const ModelOpcUa::SimpleNode> TransformToNodeIds(
 					ModelOpcUa::NodeId_t startNode,
@@ -82,16 +110,28 @@ namespace Umati {
 
 			void subscribeValues(
 					const std::shared_ptr<const ModelOpcUa::SimpleNode> pNode,
-					std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-					std::mutex &valueMap_mutex
-			);
+					DataSetStorage_t &dataSetStorage);
 
 			std::vector<std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>> m_subscribedValues;
+			/// NodeIds with an active subscription (or one queued in m_pendingSubscriptions)
+			std::unordered_set<ModelOpcUa::NodeId_t> m_subscribedNodeIds;
+
+			/// Subscriptions collected by subscribeValues, created with one SubscribeMany call by subscribePending
+			struct PendingSubscriptions_t {
+				std::vector<ModelOpcUa::NodeId_t> nodeIds;
+				std::vector<IDashboardDataClient::newValueCallbackFunction_t> callbacks;
+			} m_pendingSubscriptions;
+
+			void subscribePending();
 			std::shared_ptr<IDashboardDataClient> m_pDashboardDataClient;
 			std::shared_ptr<IPublisher> m_pPublisher;
 			std::shared_ptr<OpcUaTypeReader> m_pTypeReader;
+			/// Called after a value of any data set changed, must not block
+			std::function<void()> m_onValueChanged;
 
-			std::set<ModelOpcUa::NodeId_t> browsedNodes;
+			ModelOpcUa::NodeIdSet_t browsedNodes;
+			/// Next SimpleNode::ValueSlot, reset for each data set
+			std::size_t m_nextValueSlot = 0;
 			std::recursive_mutex m_dataSetMutex;
 			std::list<std::shared_ptr<DataSetStorage_t>> m_dataSets;
 			std::map<std::string, LastMessage_t> m_latestMessages;
@@ -99,20 +139,16 @@ namespace Umati {
 			bool isMandatoryOrOptionalVariable(const std::shared_ptr<const ModelOpcUa::SimpleNode> &pNode);
 
 			void handleSubscribeChildNodes(const std::shared_ptr<const ModelOpcUa::SimpleNode> &pNode,
-										   std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-										   std::mutex &valueMap_mutex);
+										   DataSetStorage_t &dataSetStorage);
 
 			void handleSubscribePlaceholderChildNode(const std::shared_ptr<const ModelOpcUa::Node> &pChildNode,
-													 std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-													 std::mutex &valueMap_mutex);
+													 DataSetStorage_t &dataSetStorage);
 
 			void subscribeValue(const std::shared_ptr<const ModelOpcUa::SimpleNode> &pNode,
-								std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-								std::mutex &valueMap_mutex);
+								DataSetStorage_t &dataSetStorage);
 
 			void handleSubscribeChildNode(const std::shared_ptr<const ModelOpcUa::Node> &pChildNode,
-										  std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-										  std::mutex &valueMap_mutex);
+										  DataSetStorage_t &dataSetStorage);
 
 			void preparePlaceholderNodesTypeId(
 					const std::shared_ptr<const ModelOpcUa::StructurePlaceholderNode> &pStructurePlaceholder,
@@ -122,11 +158,13 @@ namespace Umati {
 			std::shared_ptr<DataSetStorage_t> prepareDataSetStorage(const ModelOpcUa::NodeId_t &startNodeId,
 																	const std::shared_ptr<ModelOpcUa::StructureNode> &pTypeDefinition,
 																	const std::string &channel,
-																	const std::string &onlineChannel);
+																	const std::string &onlineChannel,
+																	const std::string &patchChannel);
 
 			bool OptionalAndMandatoryTransformToNodeId(const ModelOpcUa::NodeId_t &startNode,
 													   std::list<std::shared_ptr<const ModelOpcUa::Node>> &foundChildNodes,
-													   const std::shared_ptr<ModelOpcUa::StructureNode> &pChild);
+													   const std::shared_ptr<ModelOpcUa::StructureNode> &pChild,
+													   const IDashboardDataClient::TranslateBrowsePathResult_t &translatedChild);
 
 			bool OptionalAndMandatoryPlaceholderTransformToNodeId(const ModelOpcUa::NodeId_t &startNode,
 																  std::list<std::shared_ptr<const ModelOpcUa::Node>> &foundChildNodes,
@@ -8,15 +8,23 @@
 
 #include "IDashboardDataClient.hpp"
 
+#include <easylogging++.h>
+
 namespace Umati {
 	namespace Dashboard {
 		IDashboardDataClient::ValueSubscriptionHandle::~ValueSubscriptionHandle() = default;
 
-		ModelOpcUa::ModellingRule_t IDashboardDataClient::BrowseModellingRule(ModelOpcUa::NodeId_t nodeId)
+		constexpr std::chrono::seconds::rep IDashboardDataClient::AsyncResultTimeout_s;
+
+		static IDashboardDataClient::BrowseContext_t modellingRuleBrowseContext()
+		{
+			IDashboardDataClient::BrowseContext_t brContext;
+			brContext.nodeClassMask = (std::uint32_t) IDashboardDataClient::BrowseContext_t::NodeClassMask::OBJECT;
+			return brContext;
+		}
+
+		static ModelOpcUa::ModellingRule_t modellingRuleFromBrowseResults(const std::list<ModelOpcUa::BrowseResult_t> &browseResults)
 		{
-			BrowseContext_t brContext;
-			brContext.nodeClassMask = (std::uint32_t) BrowseContext_t::NodeClassMask::OBJECT;
-			auto browseResults = this->Browse(nodeId, brContext);
 			for(auto & browseResult : browseResults)
 			{
 				///\TODO Use NodeId!
@@ -39,5 +47,111 @@ namespace Umati {
 			}
 			return ModelOpcUa::ModellingRule_t::Optional;
 		}
+
+		std::vector<std::list<ModelOpcUa::BrowseResult_t>> IDashboardDataClient::BrowseMany(
+			const std::vector<ModelOpcUa::NodeId_t> &startNodes,
+			BrowseContext_t browseContext)
+		{
+			std::vector<std::list<ModelOpcUa::BrowseResult_t>> ret;
+			ret.reserve(startNodes.size());
+			for(const auto &startNode : startNodes)
+			{
+				ret.push_back(this->Browse(startNode, browseContext));
+			}
+			return ret;
+		}
+
+		std::vector<IDashboardDataClient::TranslateBrowsePathResult_t> IDashboardDataClient::TranslateBrowsePathsToNodeIds(
+			const ModelOpcUa::NodeId_t &startNode,
+			const std::vector<ModelOpcUa::QualifiedName_t> &browseNames)
+		{
+			std::vector<TranslateBrowsePathResult_t> ret(browseNames.size());
+			for(std::size_t i = 0; i < browseNames.size(); ++i)
+			{
+				try
+				{
+					ret[i].TargetNodeId = this->TranslateBrowsePathToNodeId(startNode, browseNames[i]);
+				}
+				catch (std::exception &ex)
+				{
+					ret[i].Error = ex.what();
+				}
+			}
+			return ret;
+		}
+
+		std::vector<std::shared_ptr<IDashboardDataClient::ValueSubscriptionHandle>> IDashboardDataClient::SubscribeMany(
+			const std::vector<ModelOpcUa::NodeId_t> &nodeIds,
+			const std::vector<newValueCallbackFunction_t> &callbacks,
+			double /*samplingInterval_ms*/)
+		{
+			std::vector<std::shared_ptr<ValueSubscriptionHandle>> ret(nodeIds.size());
+			for(std::size_t i = 0; i < nodeIds.size() && i < callbacks.size(); ++i)
+			{
+				try
+				{
+					ret[i] = this->Subscribe(nodeIds[i], callbacks[i]);
+				}
+				catch (std::exception &ex)
+				{
+					LOG(WARNING) << "Subscribe failed for " << nodeIds[i] << ": " << ex.what();
+				}
+			}
+			return ret;
+		}
+
+		template<typename T, typename F>
+		static std::future<T> runSynchronously(F &&function)
+		{
+			std::promise<T> promise;
+			try
+			{
+				promise.set_value(function());
+			}
+			catch (...)
+			{
+				promise.set_exception(std::current_exception());
+			}
+			return promise.get_future();
+		}
+
+		std::future<std::vector<nlohmann::json>> IDashboardDataClient::ReadAsync(std::list<ModelOpcUa::NodeId_t> nodeIds)
+		{
+			return runSynchronously<std::vector<nlohmann::json>>([&]() {
+				return this->ReadeNodeValues(nodeIds);
+			});
+		}
+
+		std::future<std::vector<IDashboardDataClient::TranslateBrowsePathResult_t>> IDashboardDataClient::TranslateAsync(
+			const ModelOpcUa::NodeId_t &startNode,
+			const std::vector<ModelOpcUa::QualifiedName_t> &browseNames)
+		{
+			return runSynchronously<std::vector<TranslateBrowsePathResult_t>>([&]() {
+				return this->TranslateBrowsePathsToNodeIds(startNode, browseNames);
+			});
+		}
+
+		std::shared_ptr<IDashboardDataClient::ValueSubscriptionHandle>
+		IDashboardDataClient::SubscribeModelChanges(modelChangeCallbackFunction_t /*callback*/)
+		{
+			return nullptr;
+		}
+
+		ModelOpcUa::ModellingRule_t IDashboardDataClient::BrowseModellingRule(ModelOpcUa::NodeId_t nodeId)
+		{
+			auto browseResults = this->Browse(nodeId, modellingRuleBrowseContext());
+			return modellingRuleFromBrowseResults(browseResults);
+		}
+
+		std::vector<ModelOpcUa::ModellingRule_t> IDashboardDataClient::BrowseModellingRules(const std::vector<ModelOpcUa::NodeId_t> &nodeIds)
+		{
+			std::vector<ModelOpcUa::ModellingRule_t> ret;
+			ret.reserve(nodeIds.size());
+			for(const auto &browseResults : this->BrowseMany(nodeIds, modellingRuleBrowseContext()))
+			{
+				ret.push_back(modellingRuleFromBrowseResults(browseResults));
+			}
+			return ret;
+		}
 	}
 }
\ No newline at end of file
@@ -10,8 +10,13 @@
 
 #include <nlohmann/json.hpp>
 #include <ModelOpcUa/ModelDefinition.hpp>
+#include <chrono>
 #include <functional>
+#include <future>
+#include <list>
+#include <vector>
 #include "NodeIdsWellKnown.hpp"
+#include "Exceptions/UmatiException.hpp"
 
 namespace Umati
 {
@@ -107,6 +112,20 @@ namespace Umati
                     return ret;
                 }
 
+                inline static BrowseContext_t HasSubtype()
+                {
+                    BrowseContext_t ret;
+                    ret.referenceTypeId = NodeId_HasSubtype;
+                    return ret;
+                }
+
+                inline static BrowseContext_t SubtypeOf() {
+                    BrowseContext_t ret;
+                    ret.referenceTypeId = NodeId_HasSubtype;
+                    ret.browseDirection = BrowseDirection::BACKWARD;
+                    return ret;
+                }
+
                 inline static BrowseContext_t WithReference(
                     ModelOpcUa::NodeId_t referenceTypeId)
                 {
@@ -127,6 +146,16 @@ namespace Umati
                     return ret;
                 }
 
+                inline static BrowseContext_t ObjectAndVariable()
+                {
+                    BrowseContext_t ret;
+                    ret.nodeClassMask =
+                    (std::uint32_t)NodeClassMask::OBJECT |
+                    (std::uint32_t)NodeClassMask::VARIABLE;
+                    ret.referenceTypeId = NodeId_HierarchicalReferences;
+                    return ret;
+                }
+
                 inline static BrowseContext_t Variable()
                 {
                     BrowseContext_t ret;
@@ -143,6 +172,14 @@ namespace Umati
                 ModelOpcUa::NodeId_t startNode,
                 BrowseContext_t browseContext) = 0;
 
+            /// Browse several start nodes with the same browse context.
+            /// Returns one result list per start node, in the order of startNodes.
+            /// Start nodes that could not be browsed yield an empty list.
+            virtual std::vector<std::list<ModelOpcUa::BrowseResult_t>>
+            BrowseMany(
+                const std::vector<ModelOpcUa::NodeId_t> &startNodes,
+                BrowseContext_t browseContext);
+
             virtual bool
             isSameOrSubtype(
                 const ModelOpcUa::NodeId_t &expectedType,
@@ -176,11 +213,26 @@ namespace Umati
 
             ModelOpcUa::ModellingRule_t BrowseModellingRule(ModelOpcUa::NodeId_t nodeId);
 
+            /// Batched variant of BrowseModellingRule, one entry per node in nodeIds.
+            std::vector<ModelOpcUa::ModellingRule_t> BrowseModellingRules(const std::vector<ModelOpcUa::NodeId_t> &nodeIds);
+
             virtual ModelOpcUa::NodeId_t TranslateBrowsePathToNodeId(
                 ModelOpcUa::NodeId_t startNode,
                 ModelOpcUa::QualifiedName_t browseName) = 0;
 
-            std::map<std::string, uint16_t> m_uriToIndexCache;
+            struct TranslateBrowsePathResult_t
+            {
+                /// Null if the browse path could not be resolved
+                ModelOpcUa::NodeId_t TargetNodeId;
+                /// Reason why the browse path could not be resolved, empty on success
+                std::string Error;
+            };
+
+            /// Batched variant of TranslateBrowsePathToNodeId, resolves all browseNames relative to startNode.
+            /// Returns one result per browse name, in the order of browseNames.
+            virtual std::vector<TranslateBrowsePathResult_t> TranslateBrowsePathsToNodeIds(
+                const ModelOpcUa::NodeId_t &startNode,
+                const std::vector<ModelOpcUa::QualifiedName_t> &browseNames);
 
             class ValueSubscriptionHandle
             {
@@ -221,10 +273,64 @@ namespace Umati
             virtual std::shared_ptr<ValueSubscriptionHandle>
             Subscribe(ModelOpcUa::NodeId_t nodeId, newValueCallbackFunction_t callback) = 0;
 
+            /// Sampling interval requested for monitored values unless another one is given
+            static constexpr double DefaultSamplingInterval_ms = 300.0;
+
+            /// Batched variant of Subscribe, callbacks[i] is registered for nodeIds[i].
+            /// Returns one handle per node in the order of nodeIds, nullptr if the node could not be subscribed.
+            /// The default implementation ignores samplingInterval_ms.
+            virtual std::vector<std::shared_ptr<ValueSubscriptionHandle>>
+            SubscribeMany(
+                const std::vector<ModelOpcUa::NodeId_t> &nodeIds,
+                const std::vector<newValueCallbackFunction_t> &callbacks,
+                double samplingInterval_ms = DefaultSamplingInterval_ms);
+
             virtual void Unsubscribe(std::vector<int32_t> monItemIds, std::vector<int32_t> clientHandles) = 0;
 
+            /// One entry of the Changes of a GeneralModelChangeEvent or SemanticChangeEvent
+            struct ModelChange_t
+            {
+                /// Node whose references or semantic changed
+                ModelOpcUa::NodeId_t Affected;
+                ModelOpcUa::NodeId_t AffectedType;
+            };
+            /// Called once per event, an empty list means that the server did not report which nodes changed
+            typedef std::function<void(const std::vector<ModelChange_t> &changes)> modelChangeCallbackFunction_t;
+
+            /// Subscribe to GeneralModelChangeEvents and SemanticChangeEvents emitted by the Server object.
+            /// The callback is released by Unsubscribe with the returned handle.
+            /// \return nullptr if the server does not provide these events, the default implementation always returns nullptr
+            virtual std::shared_ptr<ValueSubscriptionHandle> SubscribeModelChanges(modelChangeCallbackFunction_t callback);
+
             virtual std::vector<nlohmann::json> ReadeNodeValues(std::list<ModelOpcUa::NodeId_t> nodeIds) = 0;
 
+            /// Asynchronous variants of ReadeNodeValues and TranslateBrowsePathsToNodeIds.
+            /// Several requests can be in flight at the same time, errors are reported through the future.
+            /// The responses are processed by the thread driving the client (DashboardOpcUaClient::Iterate), so never wait
+            /// for a result on that thread or while holding the client lock, use waitForResult.
+            /// The default implementations run the synchronous call and return a ready future.
+            virtual std::future<std::vector<nlohmann::json>> ReadAsync(std::list<ModelOpcUa::NodeId_t> nodeIds);
+
+            virtual std::future<std::vector<TranslateBrowsePathResult_t>>
+            TranslateAsync(
+                const ModelOpcUa::NodeId_t &startNode,
+                const std::vector<ModelOpcUa::QualifiedName_t> &browseNames);
+
+            /// Timeout of waitForResult, requests time out in the client long before
+            static constexpr std::chrono::seconds::rep AsyncResultTimeout_s = 60;
+
+            /// Wait for the result of an asynchronous call, throws if it did not arrive in time,
+            /// e.g. because nobody processes the responses anymore
+            template<typename T>
+            static T waitForResult(std::future<T> &future)
+            {
+                if (future.wait_for(std::chrono::seconds(AsyncResultTimeout_s)) != std::future_status::ready)
+                {
+                    throw Exceptions::UmatiException("No result of an asynchronous request");
+                }
+                return future.get();
+            }
+
             virtual std::vector<std::string> Namespaces() = 0;
 
             /// Verify that the connection and session are ok
@@ -18,9 +18,12 @@ namespace Umati
         const ModelOpcUa::NodeId_t NodeId_HasTypeDefinition = {ns0Uri, "i=40"};
         const ModelOpcUa::NodeId_t NodeId_HasInterface = {ns0Uri, "i=17603"};
         const ModelOpcUa::NodeId_t NodeId_Organizes = {ns0Uri, "i=35"};
+        const ModelOpcUa::NodeId_t NodeId_HasSubtype = {ns0Uri, "i=45"};
         const ModelOpcUa::NodeId_t NodeId_BaseVariableType = {ns0Uri, "i=63"};
         const ModelOpcUa::NodeId_t NodeId_BaseObjectType = {ns0Uri, "i=58"};
         const ModelOpcUa::NodeId_t NodeId_Folder = {ns0Uri, "i=61"};
+        const ModelOpcUa::NodeId_t NodeId_Server = {ns0Uri, "i=2253"};
+        const ModelOpcUa::NodeId_t NodeId_Server_Namespaces = {ns0Uri, "i=11715"};
         const ModelOpcUa::NodeId_t NodeId_UndefinedType = {ns0Uri, "i=0"};
         const ModelOpcUa::NodeId_t NodeId_MissingType = {"", "i=0"};
         const std::string nsUriMachinery = "http://opcfoundation.org/UA/Machinery/";
@@ -8,8 +8,10 @@
  */
 
 #include "OpcUaTypeReader.hpp"
+#include "TypeCacheFile.hpp"
 #include <easylogging++.h>
 #include <regex>
+#include <algorithm>
 #include <Exceptions/OpcUaException.hpp>
 
  namespace Umati
@@ -20,9 +22,10 @@
         OpcUaTypeReader::OpcUaTypeReader(
             std::shared_ptr<IDashboardDataClient> pIClient,
             std::vector<std::string> expectedObjectTypeNamespaces,
-            std::vector<Umati::Util::NamespaceInformation> namespaceInformations)
+            std::vector<Umati::Util::NamespaceInformation> namespaceInformations,
+            std::string typeCacheFile)
             : m_expectedObjectTypeNamespaces(std::move(expectedObjectTypeNamespaces)),
-              m_pClient(pIClient)
+              m_pClient(pIClient), m_typeCacheFile(std::move(typeCacheFile))
         {
             for (auto const &el: namespaceInformations) {
                 m_availableObjectTypeNamespaces[el.Namespace] = el;
@@ -42,46 +45,90 @@
 
         void OpcUaTypeReader::readTypes()
         {
-            std::vector<std::string> notFoundObjectTypeNamespaces;
-            auto bidirectionalTypeMap =
-                std::make_shared<
-                    std::map<
-                        ModelOpcUa::NodeId_t,
-                        std::shared_ptr<ModelOpcUa::StructureBiNode>>>();
-            initialize(notFoundObjectTypeNamespaces);
-            LOG(INFO) << "Browsing variable types.";
-            browseObjectOrVariableTypeAndFillBidirectionalTypeMap(NodeId_BaseVariableType, bidirectionalTypeMap, true);
-            LOG(INFO) << "Browsing variable types finished, continuing browsing object types";
-
-            browseObjectOrVariableTypeAndFillBidirectionalTypeMap(NodeId_BaseObjectType, bidirectionalTypeMap, false);
-            LOG(INFO) << "Browsing object types finished";
+            std::lock_guard<decltype(m_types_mutex)> l(m_types_mutex);
+            nlohmann::json cacheKey;
+            if (!m_typeCacheFile.empty())
+            {
+                cacheKey = typeCacheKey();
+                if (!cacheKey.is_null() && TypeCacheFile(m_typeCacheFile).load(cacheKey, *m_typeMap, *m_nameToId))
+                {
+                    updateObjectTypeNames();
+                    return;
+                }
+            }
 
             auto namespaces = m_pClient->Namespaces();
-            for (std::size_t iNamespace = 0; iNamespace < namespaces.size(); ++iNamespace)
+            for (const auto &expectedObjectTypeNamespace : m_expectedObjectTypeNamespaces)
             {
-                auto namespaceURI = namespaces[iNamespace];
-                auto it = find(notFoundObjectTypeNamespaces.begin(), notFoundObjectTypeNamespaces.end(), namespaceURI);
-                if (it == notFoundObjectTypeNamespaces.end())
+                if (std::find(namespaces.begin(), namespaces.end(), expectedObjectTypeNamespace) == namespaces.end())
                 {
-                    continue;
+                    LOG(WARNING) << "Unable to find namespace " << expectedObjectTypeNamespace;
                 }
-                else
+            }
+
+            // Only the configured machine and identification types are resolved here,
+            // all other types are browsed when they are needed for the first time.
+            for (const auto &el : m_identificationTypeOfTypeDefinition)
+            {
+                findTypeStructureNode(el.second);
+            }
+            updateObjectTypeNames();
+            LOG(INFO) << "Resolved " << m_typeMap->size() << " types";
+
+            // printTypeMapYaml();
+
+            if (!cacheKey.is_null())
+            {
+                TypeCacheFile(m_typeCacheFile).store(cacheKey, *m_typeMap, *m_nameToId);
+            }
+        }
+
+        nlohmann::json OpcUaTypeReader::typeCacheKey()
+        {
+            static const std::vector<ModelOpcUa::QualifiedName_t> metadataProperties{
+                {ns0Uri, "NamespaceUri"}, {ns0Uri, "NamespaceVersion"}, {ns0Uri, "NamespacePublicationDate"}};
+
+            nlohmann::json metadata = nlohmann::json::array();
+            try
+            {
+                // One NamespaceMetadataType object per namespace below Server/Namespaces
+                std::vector<ModelOpcUa::NodeId_t> metadataNodeIds;
+                for (const auto &browseResult : m_pClient->Browse(NodeId_Server_Namespaces, IDashboardDataClient::BrowseContext_t::Hierarchical()))
                 {
-                    notFoundObjectTypeNamespaces.erase(it);
+                    metadataNodeIds.push_back(browseResult.NodeId);
+                }
+                for (const auto &metadataNodeId : metadataNodeIds)
+                {
+                    std::list<ModelOpcUa::NodeId_t> propertyNodeIds;
+                    for (const auto &result : m_pClient->TranslateBrowsePathsToNodeIds(metadataNodeId, metadataProperties))
+                    {
+                        if (!result.TargetNodeId.isNull())
+                        {
+                            propertyNodeIds.push_back(result.TargetNodeId);
+                        }
+                    }
+                    if (!propertyNodeIds.empty())
+                    {
+                        metadata.push_back(m_pClient->ReadeNodeValues(propertyNodeIds));
+                    }
                 }
-                findObjectTypeNamespacesAndCreateTypeMap(
-                    namespaceURI,
-                    bidirectionalTypeMap);
+            }
+            catch (const Umati::Exceptions::UmatiException &ex)
+            {
+                LOG(INFO) << "Unable to read NamespaceMetadata: " << ex.what();
+                metadata.clear();
             }
 
-            for (auto &notFoundObjectTypeNamespace : notFoundObjectTypeNamespaces)
+            if (metadata.empty())
             {
-                LOG(WARNING) << "Unable to find namespace " << notFoundObjectTypeNamespace;
+                LOG(INFO) << "Server provides no NamespaceMetadata, type cache not used.";
+                return nullptr;
             }
 
-            // printTypeMapYaml();
-            updateTypeMap();
-            updateObjectTypeNames();
+            return {
+                {"Namespaces", m_pClient->Namespaces()},
+                {"NamespaceMetadata", std::move(metadata)},
+                {"ObjectTypeNamespaces", m_expectedObjectTypeNamespaces}};
         }
         void OpcUaTypeReader::updateObjectTypeNames() {
             m_expectedObjectTypeNames.clear();
@@ -101,183 +148,224 @@
             }
         }
 
-        void OpcUaTypeReader::initialize(std::vector<std::string> &notFoundObjectTypeNamespaces)
-        {
-            for (auto &m_expectedObjectTypeNamespace : m_expectedObjectTypeNamespaces)
-            {
-                notFoundObjectTypeNamespaces.push_back(m_expectedObjectTypeNamespace);
-            }
-        }
-
         void OpcUaTypeReader::printTypeMapYaml() {
             for (auto mapIterator = m_typeMap->begin(); mapIterator != m_typeMap->end(); mapIterator++)
             {   
                std::cout << std::endl;
-               ModelOpcUa::StructureNode::printYamlIntern(mapIterator->second, static_cast<std::string>(mapIterator->first), 1, std::cout);
+               ModelOpcUa::StructureNode::printYamlIntern(mapIterator->second, static_cast<std::string>(mapIterator->first.nodeId()), 1, std::cout);
             }
         }
 
-        void OpcUaTypeReader::updateTypeMap()
+        void OpcUaTypeReader::linkTypeChildren(const std::shared_ptr<ModelOpcUa::StructureNode> &type)
         {
-            for (auto mapIterator = m_typeMap->begin(); mapIterator != m_typeMap->end(); mapIterator++)
+            // Children might be shared with already published types, they are only written if not linked yet
+            auto linkToType = [this](const std::shared_ptr<ModelOpcUa::StructureNode> &child) {
+                auto childType = findTypeStructureNode(child->SpecifiedTypeNodeId);
+                if (childType && child->SpecifiedChildNodes != childType->SpecifiedChildNodes)
+                {
+                    child->SpecifiedChildNodes = childType->SpecifiedChildNodes;
+                    child->ofBaseDataVariableType = childType->ofBaseDataVariableType;
+                }
+            };
+
+            for (auto childIterator = type->SpecifiedChildNodes->begin();
+                 childIterator != type->SpecifiedChildNodes->end(); childIterator++)
             {
-                for (auto childIterator = mapIterator->second->SpecifiedChildNodes->begin();
-                     childIterator != mapIterator->second->SpecifiedChildNodes->end(); childIterator++)
+                try
                 {
-                    try
-                    {
-                        auto childTypeNodeId = childIterator->get()->SpecifiedTypeNodeId;
-                        if (childTypeNodeId == Dashboard::NodeId_Folder) {
-                            for (auto childOfChildIterator = childIterator->get()->SpecifiedChildNodes->begin(); 
-                                childOfChildIterator != childIterator->get()->SpecifiedChildNodes->end(); childOfChildIterator++) {
-                                    auto childOfChild = childOfChildIterator->get()->SpecifiedTypeNodeId;
-                                    auto childType = m_typeMap->find(childOfChild);
-                                    if (childType != m_typeMap->end())
-                                    {
-                                        childOfChildIterator->get()->SpecifiedChildNodes = childType->second->SpecifiedChildNodes;
-                                        childOfChildIterator->get()->ofBaseDataVariableType = childType->second->ofBaseDataVariableType;
-                                    }
-                            } 
-                            continue;
-                        }
-                        auto childType = m_typeMap->find(childTypeNodeId);
-                        if (childType != m_typeMap->end())
-                        {
-                            childIterator->get()->SpecifiedChildNodes = childType->second->SpecifiedChildNodes;
-                            childIterator->get()->ofBaseDataVariableType = childType->second->ofBaseDataVariableType;
+                    auto childTypeNodeId = childIterator->get()->SpecifiedTypeNodeId;
+                    if (childTypeNodeId == Dashboard::NodeId_Folder) {
+                        for (auto childOfChildIterator = childIterator->get()->SpecifiedChildNodes->begin();
+                            childOfChildIterator != childIterator->get()->SpecifiedChildNodes->end(); childOfChildIterator++) {
+                                linkToType(*childOfChildIterator);
                         }
+                        continue;
                     }
-                    catch (std::exception &ex)
-                    {
-                        LOG(WARNING) << "Unable to update type due to " << ex.what();
-                    }
+                    linkToType(*childIterator);
+                }
+                catch (std::exception &ex)
+                {
+                    LOG(WARNING) << "Unable to update type due to " << ex.what();
                 }
             }
         }
 
-        void OpcUaTypeReader::browseObjectOrVariableTypeAndFillBidirectionalTypeMap(
-            const ModelOpcUa::NodeId_t &startNodeId,
-            OpcUaTypeReader::BiDirTypeMap_t bidirectionalTypeMap,
-            bool ofBaseDataVariableType)
+        std::shared_ptr<ModelOpcUa::StructureNode> OpcUaTypeReader::findTypeStructureNode(const ModelOpcUa::NodeId_t &typeDefinition)
         {
-            // startBrowseTypeResult is needed to create a startType
-            const ModelOpcUa::BrowseResult_t startBrowseTypeResult{
-                ModelOpcUa::NodeClass_t::VariableType, startNodeId, m_emptyId, m_emptyId,
-                ModelOpcUa::QualifiedName_t{startNodeId.Uri, ""} // BrowseName
-            };
-            std::weak_ptr<ModelOpcUa::StructureBiNode> emptyParent;
-            std::weak_ptr<ModelOpcUa::StructureBiNode> startType = handleBrowseTypeResult(bidirectionalTypeMap, startBrowseTypeResult, emptyParent,
-                                                    ModelOpcUa::ModellingRule_t::Mandatory,
-                                                    ofBaseDataVariableType);
-
-            browseTypes(
-                bidirectionalTypeMap,
-                startNodeId,
-                startType.lock(),
-                ofBaseDataVariableType);
-        }
+            std::lock_guard<decltype(m_types_mutex)> l(m_types_mutex);
+            const ModelOpcUa::InternedNodeId_t typeKey(typeDefinition);
+            auto typePair = m_typeMap->find(typeKey);
+            if (typePair != m_typeMap->end())
+            {
+                return typePair->second;
+            }
+            // Only types of the configured namespaces are resolved
+            if (std::find(m_expectedObjectTypeNamespaces.begin(), m_expectedObjectTypeNamespaces.end(), typeDefinition.Uri) == m_expectedObjectTypeNamespaces.end() ||
+                m_unknownTypes.count(typeDefinition) != 0)
+            {
+                return nullptr;
+            }
 
-        void OpcUaTypeReader::findObjectTypeNamespacesAndCreateTypeMap(
-            const std::string &namespaceURI,
-            OpcUaTypeReader::BiDirTypeMap_t bidirectionalTypeMap)
-        {
-            setupTypeMap(bidirectionalTypeMap, namespaceURI);
+            try
+            {
+                auto type = createTypeStructureNode(resolveBiType(typeDefinition));
+                // Insert before linking, so that children of the type's own type end up at this entry
+                m_typeMap->insert(std::make_pair(typeKey, type));
+                linkTypeChildren(type);
+                return type;
+            }
+            catch (const Umati::MachineObserver::Exceptions::MachineInvalidException &ex)
+            {
+                LOG(WARNING) << "Unable to resolve type " << static_cast<std::string>(typeDefinition) << ": " << ex.what();
+                m_unknownTypes.insert(typeDefinition);
+            }
+            catch (const Umati::Exceptions::UmatiException &ex)
+            {
+                LOG(WARNING) << "Unable to resolve type " << static_cast<std::string>(typeDefinition) << ": " << ex.what();
+            }
+            return nullptr;
         }
 
-        void
-        OpcUaTypeReader::setupTypeMap(OpcUaTypeReader::BiDirTypeMap_t &bidirectionalTypeMap, std::string namespaceUri)
+        std::shared_ptr<ModelOpcUa::StructureBiNode> OpcUaTypeReader::resolveBiType(const ModelOpcUa::NodeId_t &typeDefinition)
         {
-            for (auto &typeIterator : *bidirectionalTypeMap)
+            auto typeIt = m_bidirectionalTypeMap->find(typeDefinition);
+            if (typeIt != m_bidirectionalTypeMap->end())
+            {
+                return typeIt->second;
+            }
+
+            std::shared_ptr<ModelOpcUa::StructureBiNode> type;
+            if (typeDefinition == NodeId_BaseObjectType || typeDefinition == NodeId_BaseVariableType)
+            {
+                // Roots of the type hierarchy, their InstanceDeclarations are inherited by all types of the hierarchy
+                const ModelOpcUa::BrowseResult_t rootBrowseResult{
+                    ModelOpcUa::NodeClass_t::VariableType, typeDefinition, m_emptyId, m_emptyId,
+                    ModelOpcUa::QualifiedName_t{typeDefinition.Uri, ""} // BrowseName
+                };
+                type = handleBrowseTypeResult(m_bidirectionalTypeMap, rootBrowseResult, std::weak_ptr<ModelOpcUa::StructureBiNode>(),
+                                              ModelOpcUa::ModellingRule_t::Mandatory, typeDefinition == NodeId_BaseVariableType);
+            }
+            else
             {
-                if (typeIterator.second->namespaceUri != namespaceUri)
+                auto superTypes = m_pClient->Browse(typeDefinition, IDashboardDataClient::BrowseContext_t::SubtypeOf());
+                if (superTypes.empty())
                 {
-                    continue;
+                    throw Umati::MachineObserver::Exceptions::MachineInvalidException("Type not found");
                 }
-                // go to highest parent and then down the ladder to add / update attributes;
-                // create a list of pointers till parent is null
-                // go backwards and add / update child nodes till the end
-                std::shared_ptr<std::list<std::shared_ptr<ModelOpcUa::StructureBiNode>>>
-                    bloodline = std::make_shared<std::list<std::shared_ptr<ModelOpcUa::StructureBiNode>>>();
-                std::shared_ptr<ModelOpcUa::StructureBiNode> currentGeneration = typeIterator.second;
-                while (nullptr != currentGeneration)
+                auto superTypeNodeId = superTypes.front().NodeId;
+                auto superType = resolveBiType(superTypeNodeId);
+
+                // The reference description of the type itself is part of the supertype's HasSubtype references
+                auto subTypes = m_pClient->Browse(superTypeNodeId, IDashboardDataClient::BrowseContext_t::HasSubtype());
+                auto typeBrowseResult = std::find_if(subTypes.begin(), subTypes.end(), [&](const ModelOpcUa::BrowseResult_t &subType) {
+                    return subType.NodeId == typeDefinition;
+                });
+                if (typeBrowseResult == subTypes.end())
                 {
-                    bloodline->emplace_back(currentGeneration);
-                    currentGeneration = currentGeneration->parent.lock();
+                    throw Umati::MachineObserver::Exceptions::MachineInvalidException("Type not found below its supertype");
                 }
-                std::string typeName = bloodline->front()->structureNode->SpecifiedBrowseName.Uri + ";" +
-                                       bloodline->front()->structureNode->SpecifiedBrowseName.Name;
-                ModelOpcUa::StructureNode node = bloodline->front()->structureNode.operator*();
-                node.ofBaseDataVariableType = bloodline->front()->ofBaseDataVariableType;
-                std::stringstream bloodlineStringStream;
-
-                for (auto bloodlineIterator = bloodline->rbegin();
-                     bloodlineIterator != bloodline->rend();
-                     ++bloodlineIterator)
+                type = handleBrowseTypeResult(m_bidirectionalTypeMap, *typeBrowseResult, superType,
+                                              ModelOpcUa::ModellingRule_t::None, superType->ofBaseDataVariableType);
+            }
+
+            browseTypes(m_bidirectionalTypeMap, typeDefinition, type, type->ofBaseDataVariableType);
+            return type;
+        }
+
+        std::shared_ptr<ModelOpcUa::StructureNode>
+        OpcUaTypeReader::createTypeStructureNode(const std::shared_ptr<ModelOpcUa::StructureBiNode> &type)
+        {
+            // go to highest parent and then down the ladder to add / update attributes;
+            // create a list of pointers till parent is null
+            // go backwards and add / update child nodes till the end
+            std::shared_ptr<std::list<std::shared_ptr<ModelOpcUa::StructureBiNode>>>
+                bloodline = std::make_shared<std::list<std::shared_ptr<ModelOpcUa::StructureBiNode>>>();
+            std::shared_ptr<ModelOpcUa::StructureBiNode> currentGeneration = type;
+            while (nullptr != currentGeneration)
+            {
+                bloodline->emplace_back(currentGeneration);
+                currentGeneration = currentGeneration->parent.lock();
+            }
+            std::string typeName = bloodline->front()->structureNode->SpecifiedBrowseName.Uri + ";" +
+                                   bloodline->front()->structureNode->SpecifiedBrowseName.Name;
+            ModelOpcUa::StructureNode node = bloodline->front()->structureNode.operator*();
+            node.ofBaseDataVariableType = bloodline->front()->ofBaseDataVariableType;
+            std::stringstream bloodlineStringStream;
+
+            for (auto bloodlineIterator = bloodline->rbegin();
+                 bloodlineIterator != bloodline->rend();
+                 ++bloodlineIterator)
+            {
+                auto ancestor = *bloodlineIterator;
+                bloodlineStringStream << "->" << static_cast<std::string>(ancestor->structureNode->SpecifiedBrowseName);
+
+                // Ancestor is a SuperType of the analysed node (var node)
+                // Iterate over the children of the ancestor (var ancestor)
+                // (var currentChild) is a child of the ancestor
+                // Example: (var node) = ProductionProgramStateMachineType (ns=MachineTool;i=15)
+                //          (var ancestor.1) = ProductionStateMachineType (ns=MachineTool;i=24)
+                //          (var ancestor.2) = FiniteStateMachineType (ns=0;i=2771)
+                for (auto &currentChild : *ancestor->SpecifiedBiChildNodes)
                 {
-                    auto ancestor = *bloodlineIterator;
-                    bloodlineStringStream << "->" << static_cast<std::string>(ancestor->structureNode->SpecifiedBrowseName);
-
-                    // Ancestor is a SuperType of the analysed node (var node)
-                    // Iterate over the children of the ancestor (var ancestor)
-                    // (var currentChild) is a child of the ancestor
-                    // Example: (var node) = ProductionProgramStateMachineType (ns=MachineTool;i=15)
-                    //          (var ancestor.1) = ProductionStateMachineType (ns=MachineTool;i=24)
-                    //          (var ancestor.2) = FiniteStateMachineType (ns=0;i=2771)
-                    for (auto &currentChild : *ancestor->SpecifiedBiChildNodes)
+                    if (currentChild->isType)
                     {
-                        if (currentChild->isType)
-                        {
-                            continue;
-                        }
-                        auto structureNode = currentChild->toStructureNode();
+                        continue;
+                    }
+                    auto structureNode = currentChild->toStructureNode();
 
-                        // Lookup if ancestor's child currentChild is child of the node.
-                        auto findIterator = std::find_if(node.SpecifiedChildNodes->begin(), node.SpecifiedChildNodes->end(), [&](const auto &el) {
-                            return el == structureNode || el->SpecifiedBrowseName == structureNode->SpecifiedBrowseName;
-                        });
+                    // Lookup if ancestor's child currentChild is child of the node.
+                    auto findIterator = std::find_if(node.SpecifiedChildNodes->begin(), node.SpecifiedChildNodes->end(), [&](const auto &el) {
+                        return el == structureNode || el->SpecifiedBrowseName == structureNode->SpecifiedBrowseName;
+                    });
 
-                        /// \todo Check if a merge is required here!
-                        // Ancestor's child currentChild is child of the node.
-                        // (var findIterator) contains the child of the node.
-                        if (findIterator != node.SpecifiedChildNodes->end())
+                    /// \todo Check if a merge is required here!
+                    // Ancestor's child currentChild is child of the node.
+                    // (var findIterator) contains the child of the node.
+                    if (findIterator != node.SpecifiedChildNodes->end())
+                    {
+                        // The child might be an InstanceDeclaration of a supertype that is also part of other types,
+                        // merge into a copy instead.
+                        if (*findIterator != structureNode)
                         {
-                            // (var structureNodeChildren) contains children of the child of the ancestor, which is also contained in the node.
-                            auto structureNodeChildren = structureNode->SpecifiedChildNodes;
-
-                            // Iterate over children of the child of the ancestor.
-                            // If there are children which are contained in ancestor->child and not in node->child, add them to node->child
-                            // Example: Ancestor FiniteStateMachineType is an ancestor of ProductionStateMachineType, both contain a node CurrentState
-                            // ProductionStateMachineType->CurrentState does not contain the node "Number", but FiniteStateMachineType->CurrentState->Number does exist
-                            // Thus, we add node "Number" to SpecifiedChildNodes of ProductionStateMachineType->CurrentState.
-                            for (auto &childOfChild : *structureNodeChildren) {
-                                auto findIt = std::find_if(findIterator->get()->SpecifiedChildNodes->begin(), findIterator->get()->SpecifiedChildNodes->end(), [&](const auto &el) {
-                                    return el == childOfChild || childOfChild->SpecifiedBrowseName == el->SpecifiedBrowseName;
-                                });
-
-                                if (findIt == findIterator->get()->SpecifiedChildNodes->end()) {
-                                    findIterator->get()->SpecifiedChildNodes->emplace_back(childOfChild);
-                                }
-                            }
-                            // Check if original child is optional, if so, override
-                            if ((*findIterator)->ModellingRule == ModelOpcUa::ModellingRule_t::Optional ||
-                                (*findIterator)->ModellingRule == ModelOpcUa::ModellingRule_t::OptionalPlaceholder)
-                            {
-                                node.SpecifiedChildNodes->erase(findIterator++);
-                                node.SpecifiedChildNodes->emplace_back(structureNode);
+                            auto mergedChild = std::make_shared<ModelOpcUa::StructureNode>(**findIterator);
+                            mergedChild->SpecifiedChildNodes = std::make_shared<std::list<std::shared_ptr<ModelOpcUa::StructureNode>>>(
+                                *mergedChild->SpecifiedChildNodes);
+                            *findIterator = mergedChild;
+                        }
+                        // (var structureNodeChildren) contains children of the child of the ancestor, which is also contained in the node.
+                        auto structureNodeChildren = structureNode->SpecifiedChildNodes;
+
+                        // Iterate over children of the child of the ancestor.
+                        // If there are children which are contained in ancestor->child and not in node->child, add them to node->child
+                        // Example: Ancestor FiniteStateMachineType is an ancestor of ProductionStateMachineType, both contain a node CurrentState
+                        // ProductionStateMachineType->CurrentState does not contain the node "Number", but FiniteStateMachineType->CurrentState->Number does exist
+                        // Thus, we add node "Number" to SpecifiedChildNodes of ProductionStateMachineType->CurrentState.
+                        for (auto &childOfChild : *structureNodeChildren) {
+                            auto findIt = std::find_if(findIterator->get()->SpecifiedChildNodes->begin(), findIterator->get()->SpecifiedChildNodes->end(), [&](const auto &el) {
+                                return el == childOfChild || childOfChild->SpecifiedBrowseName == el->SpecifiedBrowseName;
+                            });
+
+                            if (findIt == findIterator->get()->SpecifiedChildNodes->end()) {
+                                findIterator->get()->SpecifiedChildNodes->emplace_back(childOfChild);
                             }
                         }
-                        // Node's ancestor's child currentChild is not child of the node.
-                        else
+                        // Check if original child is optional, if so, override
+                        if ((*findIterator)->ModellingRule == ModelOpcUa::ModellingRule_t::Optional ||
+                            (*findIterator)->ModellingRule == ModelOpcUa::ModellingRule_t::OptionalPlaceholder)
                         {
-                            // Thus, we add it.
+                            node.SpecifiedChildNodes->erase(findIterator++);
                             node.SpecifiedChildNodes->emplace_back(structureNode);
                         }
                     }
+                    // Node's ancestor's child currentChild is not child of the node.
+                    else
+                    {
+                        // Thus, we add it.
+                        node.SpecifiedChildNodes->emplace_back(structureNode);
+                    }
                 }
-                auto shared = std::make_shared<ModelOpcUa::StructureNode>(node);
-                std::pair<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureNode>> newType(typeIterator.first, shared);
-                m_typeMap->insert(newType);
             }
+            return std::make_shared<ModelOpcUa::StructureNode>(node);
         }
 
         std::shared_ptr<ModelOpcUa::StructureBiNode> OpcUaTypeReader::handleBrowseTypeResult(
@@ -330,34 +418,72 @@
             const std::weak_ptr<ModelOpcUa::StructureBiNode> &parent,
             bool ofBaseDataVariableType)
         {
-            auto browseTypeContext = IDashboardDataClient::BrowseContext_t::ObjectAndVariableWithTypes();
-            auto browseResults = m_pClient->Browse(startNodeId, browseTypeContext);
+            // Subtypes are not followed, they are resolved on their own when needed
+            auto browseTypeContext = IDashboardDataClient::BrowseContext_t::ObjectAndVariable();
+            // Browse level by level, so that all nodes of one level are requested in a single BrowseMany call
+            std::vector<ModelOpcUa::NodeId_t> levelNodeIds{startNodeId};
+            std::vector<std::weak_ptr<ModelOpcUa::StructureBiNode>> levelParents{parent};
 
-            for (auto &browseResult : browseResults)
+            while (!levelNodeIds.empty())
             {
-                ModelOpcUa::ModellingRule_t modellingRule = ModelOpcUa::ModellingRule_t::None;
+                auto levelBrowseResults = m_pClient->BrowseMany(levelNodeIds, browseTypeContext);
+
+                std::vector<ModelOpcUa::NodeId_t> childNodeIds;
+                for (auto &browseResults : levelBrowseResults)
+                {
+                    for (auto &browseResult : browseResults)
+                    {
+                        childNodeIds.push_back(browseResult.NodeId);
+                    }
+                }
+
+                std::vector<ModelOpcUa::ModellingRule_t> modellingRules(childNodeIds.size(), ModelOpcUa::ModellingRule_t::None);
                 try {
-                    modellingRule = m_pClient->BrowseModellingRule(browseResult.NodeId);
+                    modellingRules = m_pClient->BrowseModellingRules(childNodeIds);
                 } catch (Exceptions::UmatiException &e) {
-                    LOG(ERROR) << "Error browsing modelling rule of " << browseResult.NodeId << ": " << e.what();
+                    LOG(ERROR) << "Error browsing modelling rules of " << childNodeIds.size() << " nodes: " << e.what()
+                               << ", browsing them one by one";
+                    // Only the nodes that fail on their own fall back to ModellingRule None
+                    modellingRules.assign(childNodeIds.size(), ModelOpcUa::ModellingRule_t::None);
+                    for (std::size_t i = 0; i < childNodeIds.size(); ++i)
+                    {
+                        try {
+                            modellingRules[i] = m_pClient->BrowseModellingRule(childNodeIds[i]);
+                        } catch (Exceptions::UmatiException &ex) {
+                            LOG(ERROR) << "Error browsing modelling rule of " << childNodeIds[i] << ": " << ex.what();
+                        }
+                    }
+                }
+
+                std::vector<ModelOpcUa::NodeId_t> nextLevelNodeIds;
+                std::vector<std::weak_ptr<ModelOpcUa::StructureBiNode>> nextLevelParents;
+                std::size_t iChild = 0;
+                for (std::size_t iNode = 0; iNode < levelBrowseResults.size(); ++iNode)
+                {
+                    for (auto &browseResult : levelBrowseResults[iNode])
+                    {
+                        std::weak_ptr<ModelOpcUa::StructureBiNode> current = handleBrowseTypeResult(bidirectionalTypeMap,
+                                                                                                    browseResult, levelParents[iNode],
+                                                                                                    modellingRules[iChild++],
+                                                                                                    ofBaseDataVariableType);
+                        nextLevelNodeIds.push_back(browseResult.NodeId);
+                        nextLevelParents.push_back(current);
+                    }
                 }
-                std::weak_ptr<ModelOpcUa::StructureBiNode> current = handleBrowseTypeResult(bidirectionalTypeMap,
-                                                                                            browseResult, parent,
-                                                                                            modellingRule,
-                                                                                            ofBaseDataVariableType);
-                browseTypes(bidirectionalTypeMap, browseResult.NodeId, current, ofBaseDataVariableType);
+                levelNodeIds = std::move(nextLevelNodeIds);
+                levelParents = std::move(nextLevelParents);
             }
         }
 
-        std::shared_ptr<ModelOpcUa::StructureNode> OpcUaTypeReader::typeDefinitionToStructureNode(const ModelOpcUa::NodeId_t &typeDefinition) const
+        std::shared_ptr<ModelOpcUa::StructureNode> OpcUaTypeReader::typeDefinitionToStructureNode(const ModelOpcUa::NodeId_t &typeDefinition)
         {
-            auto typePair = m_typeMap->find(typeDefinition);
-			if (typePair == m_typeMap->end())
+            auto type = findTypeStructureNode(typeDefinition);
+			if (!type)
 			{
 				LOG(ERROR) << "Unable to find " << static_cast<std::string>(typeDefinition) + " in typeMap";
 				throw Umati::MachineObserver::Exceptions::MachineInvalidException("Type not found");
 			}
-			return typePair->second;
+			return type;
         }
 
         std::string OpcUaTypeReader::CSNameFromUri(std::string nsUri)
@@ -375,7 +501,7 @@
         }
 
         std::shared_ptr<ModelOpcUa::StructureNode>
-        OpcUaTypeReader::getIdentificationTypeStructureNode(const ModelOpcUa::NodeId_t &typeDefinition) const
+        OpcUaTypeReader::getIdentificationTypeStructureNode(const ModelOpcUa::NodeId_t &typeDefinition)
 		{   
 			auto identificationTypeNodeId = getIdentificationTypeNodeId(typeDefinition);            
 			return typeDefinitionToStructureNode(identificationTypeNodeId);
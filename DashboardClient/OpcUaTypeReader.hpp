@@ -11,6 +11,9 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <mutex>
+#include <set>
+#include <ModelOpcUa/InternedNodeId.hpp>
 #include <ModelOpcUa/ModelInstance.hpp>
 #include "IDashboardDataClient.hpp"
 #include <Configuration.hpp>
@@ -27,7 +30,8 @@ namespace Umati
         public:
             OpcUaTypeReader(
                 std::shared_ptr<IDashboardDataClient> pIClient,
-                std::vector<std::string> expectedObjectTypeNamespaces, std::vector<Umati::Util::NamespaceInformation> namespaceInformations);
+                std::vector<std::string> expectedObjectTypeNamespaces, std::vector<Umati::Util::NamespaceInformation> namespaceInformations,
+                std::string typeCacheFile = std::string());
 
             ~OpcUaTypeReader();
             
@@ -41,10 +45,14 @@ namespace Umati
             std::vector<std::string> m_expectedObjectTypeNames;
             std::vector<ModelOpcUa::NodeId_t> m_knownMachineTypeDefinitions;
             std::map<ModelOpcUa::NodeId_t, ModelOpcUa::NodeId_t> m_subTypeDefinitionToKnownMachineTypeDefinition;
-            std::shared_ptr<std::map<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureNode>>> m_typeMap = std::make_shared<std::map<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureNode>>>();
+            std::shared_ptr<ModelOpcUa::NodeIdMap_t<std::shared_ptr<ModelOpcUa::StructureNode>>> m_typeMap = std::make_shared<ModelOpcUa::NodeIdMap_t<std::shared_ptr<ModelOpcUa::StructureNode>>>();
             std::shared_ptr<std::map<std::string, ModelOpcUa::NodeId_t>> m_nameToId = std::make_shared<std::map<std::string, ModelOpcUa::NodeId_t>>();
-            std::shared_ptr<ModelOpcUa::StructureNode> typeDefinitionToStructureNode(const ModelOpcUa::NodeId_t &typeDefinition) const;
-            std::shared_ptr<ModelOpcUa::StructureNode> getIdentificationTypeStructureNode(const ModelOpcUa::NodeId_t &typeDefinition) const;
+            /// Resolves the type on first use, throws MachineInvalidException if it is unknown
+            std::shared_ptr<ModelOpcUa::StructureNode> typeDefinitionToStructureNode(const ModelOpcUa::NodeId_t &typeDefinition);
+            std::shared_ptr<ModelOpcUa::StructureNode> getIdentificationTypeStructureNode(const ModelOpcUa::NodeId_t &typeDefinition);
+            /// Browses the type and its supertypes if not done yet
+            /// \return nullptr if the type is not part of the expected namespaces or could not be browsed
+            std::shared_ptr<ModelOpcUa::StructureNode> findTypeStructureNode(const ModelOpcUa::NodeId_t &typeDefinition);
             ModelOpcUa::NodeId_t getIdentificationTypeNodeId(const ModelOpcUa::NodeId_t &typeDefinition) const;
         protected:
             /// Map of <TypeName, StructureBiNode>
@@ -53,21 +61,26 @@ namespace Umati
                                              ModelOpcUa::StructureBiNode>>> BiDirTypeMap_t;
             std::shared_ptr<Umati::Dashboard::IDashboardDataClient> m_pClient;
             const ModelOpcUa::NodeId_t m_emptyId = ModelOpcUa::NodeId_t{"", ""};
-            void initialize(std::vector<std::string> &notFoundObjectTypeNamespaces);
-            void browseObjectOrVariableTypeAndFillBidirectionalTypeMap(
-                const ModelOpcUa::NodeId_t &startNodeId,
-                BiDirTypeMap_t bidirectionalTypeMap,
-                bool ofBaseDataVariableType);
+            /// Empty if types are always browsed
+            std::string m_typeCacheFile;
+            /// Guards all type maps, types are resolved on demand from the machine workers
+            std::recursive_mutex m_types_mutex;
+            BiDirTypeMap_t m_bidirectionalTypeMap = std::make_shared<std::map<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureBiNode>>>();
+            /// Types that are not available on the server, not browsed again
+            std::set<ModelOpcUa::NodeId_t> m_unknownTypes;
+
+            /// Identifies the server's type model: namespace array, NamespaceMetadata and the configured namespaces.
+            /// \return null if the server does not provide NamespaceMetadata, changes could not be detected then
+            nlohmann::json typeCacheKey();
 
             void printTypeMapYaml();
             void updateObjectTypeNames();
-            void updateTypeMap();
-            void findObjectTypeNamespacesAndCreateTypeMap(
-                const std::string &namespaceURI,
-                BiDirTypeMap_t bidirectionalTypeMap =
-                        std::make_shared<std::map<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureBiNode>>>());
-            void
-            setupTypeMap(std::shared_ptr<std::map<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureBiNode>>> &bidirectionalTypeMap, std::string namespaceUri);
+            /// Replaces the children of variables and objects by the children of their type
+            void linkTypeChildren(const std::shared_ptr<ModelOpcUa::StructureNode> &type);
+            /// Browses the supertypes (up to BaseObjectType or BaseVariableType) and the InstanceDeclarations of the type
+            std::shared_ptr<ModelOpcUa::StructureBiNode> resolveBiType(const ModelOpcUa::NodeId_t &typeDefinition);
+            /// Merges the InstanceDeclarations of all supertypes into a new StructureNode
+            std::shared_ptr<ModelOpcUa::StructureNode> createTypeStructureNode(const std::shared_ptr<ModelOpcUa::StructureBiNode> &type);
 
             std::shared_ptr<ModelOpcUa::StructureBiNode> handleBrowseTypeResult(
                 BiDirTypeMap_t &bidirectionalTypeMap,
@@ -75,7 +88,7 @@ namespace Umati
                 const std::weak_ptr<ModelOpcUa::StructureBiNode> &parent, ModelOpcUa::ModellingRule_t modellingRule,
                 bool ofBaseDataVariableType);
 
-            /// Browse all Nodes (Object, Variables, ObjectTypes, VariablesTypes) and fill the BiDirectionalTypeMap
+            /// Browse all InstanceDeclarations (Object, Variables) below startNodeId and fill the BiDirectionalTypeMap
             void browseTypes(
                 BiDirTypeMap_t bidirectionalTypeMap,
                 const ModelOpcUa::NodeId_t &startNodeId,
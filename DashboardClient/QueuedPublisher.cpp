@@ -0,0 +1,159 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "QueuedPublisher.hpp"
+
+#include <easylogging++.h>
+
+namespace Umati
+{
+
+	namespace Dashboard
+	{
+		/// Interval for logging the publish statistics
+		static const std::chrono::seconds StatisticsLogInterval(60);
+
+		QueuedPublisher::QueuedPublisher(std::shared_ptr<IPublisher> pPublisher, std::size_t warnQueueSize)
+			: m_pPublisher(std::move(pPublisher)), m_warnQueueSize(warnQueueSize == 0 ? 1 : warnQueueSize),
+			  m_lastStatisticsLog(std::chrono::steady_clock::now())
+		{
+			m_workerThread = std::thread([this]() { this->workerThread(); });
+		}
+
+		const std::chrono::milliseconds QueuedPublisher::DrainTimeout(2000);
+
+		QueuedPublisher::~QueuedPublisher()
+		{
+			{
+				std::lock_guard<decltype(m_queueMutex)> l(m_queueMutex);
+				m_running = false;
+				m_drainDeadline = std::chrono::steady_clock::now() + DrainTimeout;
+			}
+			m_queueCondition.notify_all();
+			if (m_workerThread.joinable())
+			{
+				m_workerThread.join();
+			}
+		}
+
+		void QueuedPublisher::Publish(std::string channel, std::string message)
+		{
+			bool replaced = false;
+			bool queueSizeExceeded = false;
+			{
+				std::lock_guard<decltype(m_queueMutex)> l(m_queueMutex);
+				auto it = m_pendingMessages.find(channel);
+				if (it != m_pendingMessages.end())
+				{
+					// Only the latest state of a channel is sent, the enqueue time of the first message is kept
+					it->second.message = std::move(message);
+					replaced = true;
+				}
+				else
+				{
+					m_queue.push_back(channel);
+					m_pendingMessages.emplace(std::move(channel), Message_t{std::move(message), std::chrono::steady_clock::now()});
+					if (m_queue.size() > m_warnQueueSize && !m_queueSizeExceeded)
+					{
+						m_queueSizeExceeded = true;
+						queueSizeExceeded = true;
+					}
+				}
+			}
+			m_queueCondition.notify_one();
+
+			if (replaced)
+			{
+				std::lock_guard<decltype(m_statisticsMutex)> l(m_statisticsMutex);
+				++m_statistics.replaced;
+			}
+			if (queueSizeExceeded)
+			{
+				LOG(WARNING) << "More than " << m_warnQueueSize << " channels waiting to be published";
+			}
+		}
+
+		QueuedPublisher::Statistics_t QueuedPublisher::getStatistics()
+		{
+			Statistics_t ret;
+			{
+				std::lock_guard<decltype(m_queueMutex)> l(m_queueMutex);
+				ret.queueSize = m_queue.size();
+			}
+			std::lock_guard<decltype(m_statisticsMutex)> l(m_statisticsMutex);
+			ret.published = m_statistics.published;
+			ret.replaced = m_statistics.replaced;
+			ret.maxLatency = m_statistics.maxLatency;
+			if (m_statistics.published > 0)
+			{
+				ret.avgLatency = m_sumLatency / m_statistics.published;
+			}
+			m_statistics = Statistics_t();
+			m_sumLatency = std::chrono::microseconds(0);
+			return ret;
+		}
+
+		void QueuedPublisher::workerThread()
+		{
+			std::unique_lock<decltype(m_queueMutex)> ul(m_queueMutex);
+			while (true)
+			{
+				m_queueCondition.wait_for(ul, StatisticsLogInterval, [this]() { return !m_running || !m_queue.empty(); });
+
+				while (!m_queue.empty())
+				{
+					if (!m_running && std::chrono::steady_clock::now() >= m_drainDeadline)
+					{
+						LOG(WARNING) << "Stopped publishing, " << m_queue.size() << " queued messages are discarded";
+						return;
+					}
+
+					auto it = m_pendingMessages.find(m_queue.front());
+					std::string channel = std::move(m_queue.front());
+					m_queue.pop_front();
+					Message_t message = std::move(it->second);
+					m_pendingMessages.erase(it);
+					if (m_queue.size() <= m_warnQueueSize)
+					{
+						m_queueSizeExceeded = false;
+					}
+					ul.unlock();
+
+					m_pPublisher->Publish(std::move(channel), std::move(message.message));
+					auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+						std::chrono::steady_clock::now() - message.enqueued);
+					{
+						std::lock_guard<decltype(m_statisticsMutex)> l(m_statisticsMutex);
+						++m_statistics.published;
+						m_sumLatency += latency;
+						if (latency > m_statistics.maxLatency)
+						{
+							m_statistics.maxLatency = latency;
+						}
+					}
+
+					ul.lock();
+				}
+
+				if (!m_running)
+				{
+					return;
+				}
+
+				auto now = std::chrono::steady_clock::now();
+				if (now - m_lastStatisticsLog >= StatisticsLogInterval)
+				{
+					m_lastStatisticsLog = now;
+					ul.unlock();
+					auto statistics = getStatistics();
+					LOG(INFO) << "Publish statistics: " << statistics.published << " published, "
+							  << statistics.replaced << " replaced, " << statistics.queueSize << " queued, latency avg "
+							  << statistics.avgLatency.count() << " us, max " << statistics.maxLatency.count() << " us";
+					ul.lock();
+				}
+			}
+		}
+	}
+}
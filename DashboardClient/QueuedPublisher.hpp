@@ -0,0 +1,83 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "IPublisher.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace Umati {
+	namespace Dashboard {
+
+		/**
+		* Decouples the callers of Publish from the I/O of another IPublisher (like MqttPublisher_Paho).
+		* Messages are queued and forwarded by a worker thread. At most one message per channel is queued,
+		* a newer message replaces the queued one of its channel (latest value wins) and keeps its position.
+		* So no channel loses its last state, e.g. retained online states and machine lists.
+		*/
+		class QueuedPublisher : public IPublisher {
+		public:
+			struct Statistics_t {
+				std::uint64_t published = 0;
+				/// Messages replaced by a newer message of the same channel before they were sent
+				std::uint64_t replaced = 0;
+				std::size_t queueSize = 0;
+				/// Time between Publish and the completion of the forwarded publish, since the last reset
+				std::chrono::microseconds maxLatency{0};
+				std::chrono::microseconds avgLatency{0};
+			};
+
+			/// A warning is logged if more than warnQueueSize channels are waiting, the queue itself is not limited
+			QueuedPublisher(std::shared_ptr<IPublisher> pPublisher, std::size_t warnQueueSize);
+
+			/// Sends the queued messages for at most DrainTimeout before the worker thread is stopped
+			~QueuedPublisher();
+
+			static const std::chrono::milliseconds DrainTimeout;
+
+			// Inherit from IPublisher
+			void Publish(std::string channel, std::string message) override;
+
+			/// Returns the statistics since the last call
+			Statistics_t getStatistics();
+
+		protected:
+			struct Message_t {
+				std::string message;
+				std::chrono::steady_clock::time_point enqueued;
+			};
+
+			void workerThread();
+
+			std::shared_ptr<IPublisher> m_pPublisher;
+			const std::size_t m_warnQueueSize;
+
+			std::mutex m_queueMutex;
+			std::condition_variable m_queueCondition;
+			/// Channels in the order of their first queued message
+			std::deque<std::string> m_queue;
+			std::unordered_map<std::string, Message_t> m_pendingMessages;
+			bool m_running = true;
+			bool m_queueSizeExceeded = false;
+			/// Set when stopping, queued messages are sent until then
+			std::chrono::steady_clock::time_point m_drainDeadline;
+
+			std::mutex m_statisticsMutex;
+			Statistics_t m_statistics;
+			std::chrono::microseconds m_sumLatency{0};
+			std::chrono::steady_clock::time_point m_lastStatisticsLog;
+
+			std::thread m_workerThread;
+		};
+	}
+}
@@ -0,0 +1,215 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "TypeCacheFile.hpp"
+
+#include <easylogging++.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Umati
+{
+    namespace Dashboard
+    {
+        typedef std::list<std::shared_ptr<ModelOpcUa::StructureNode>> ChildList_t;
+
+        static nlohmann::json nodeIdToJson(const ModelOpcUa::NodeId_t &nodeId)
+        {
+            return nlohmann::json::array({nodeId.Uri, nodeId.Id});
+        }
+
+        static ModelOpcUa::NodeId_t nodeIdFromJson(const nlohmann::json &json)
+        {
+            return ModelOpcUa::NodeId_t{json.at(0).get<std::string>(), json.at(1).get<std::string>()};
+        }
+
+        constexpr int TypeCacheFile::FormatVersion;
+
+        TypeCacheFile::TypeCacheFile(std::string filename)
+            : m_filename(std::move(filename))
+        {
+        }
+
+        bool TypeCacheFile::load(const nlohmann::json &cacheKey, TypeMap_t &typeMap, NameToId_t &nameToId) const
+        {
+            std::ifstream file(m_filename, std::ios::binary);
+            if (!file)
+            {
+                LOG(INFO) << "No type cache found at " << m_filename;
+                return false;
+            }
+            std::vector<std::uint8_t> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+            try
+            {
+                auto cache = nlohmann::json::from_cbor(content);
+                if (cache.value("Version", 0) != FormatVersion || cache.at("Key") != cacheKey)
+                {
+                    LOG(INFO) << "Type cache " << m_filename << " does not match the server's types, browsing types.";
+                    return false;
+                }
+
+                // Create all child lists first, so that nodes can refer to lists of nodes created later
+                const auto &jsonLists = cache.at("Lists");
+                std::vector<std::shared_ptr<ChildList_t>> lists;
+                lists.reserve(jsonLists.size());
+                for (std::size_t i = 0; i < jsonLists.size(); ++i)
+                {
+                    lists.push_back(std::make_shared<ChildList_t>());
+                }
+
+                const auto &jsonNodes = cache.at("Nodes");
+                std::vector<std::shared_ptr<ModelOpcUa::StructureNode>> nodes;
+                nodes.reserve(jsonNodes.size());
+                for (const auto &jsonNode : jsonNodes)
+                {
+                    const auto &jsonChildList = jsonNode.at(6);
+                    nodes.push_back(std::make_shared<ModelOpcUa::StructureNode>(
+                        static_cast<ModelOpcUa::NodeClass_t>(jsonNode.at(0).get<unsigned int>()),
+                        static_cast<ModelOpcUa::ModellingRule_t>(jsonNode.at(1).get<unsigned int>()),
+                        nodeIdFromJson(jsonNode.at(2)),
+                        nodeIdFromJson(jsonNode.at(3)),
+                        ModelOpcUa::QualifiedName_t{jsonNode.at(4).at(0).get<std::string>(), jsonNode.at(4).at(1).get<std::string>()},
+                        jsonNode.at(5).get<bool>(),
+                        jsonChildList.is_null() ? nullptr : lists.at(jsonChildList.get<std::size_t>())));
+                }
+
+                for (std::size_t i = 0; i < jsonLists.size(); ++i)
+                {
+                    for (const auto &nodeIndex : jsonLists[i])
+                    {
+                        lists[i]->push_back(nodes.at(nodeIndex.get<std::size_t>()));
+                    }
+                }
+
+                TypeMap_t loadedTypeMap;
+                for (const auto &entry : cache.at("TypeMap"))
+                {
+                    loadedTypeMap.emplace(nodeIdFromJson(entry.at(0)), nodes.at(entry.at(1).get<std::size_t>()));
+                }
+                NameToId_t loadedNameToId;
+                for (const auto &entry : cache.at("NameToId"))
+                {
+                    loadedNameToId.emplace(entry.at(0).get<std::string>(), nodeIdFromJson(entry.at(1)));
+                }
+
+                typeMap.swap(loadedTypeMap);
+                nameToId.swap(loadedNameToId);
+                LOG(INFO) << "Loaded " << typeMap.size() << " types from type cache " << m_filename;
+                return true;
+            }
+            catch (const nlohmann::json::exception &ex)
+            {
+                LOG(WARNING) << "Unable to parse type cache " << m_filename << ": " << ex.what();
+            }
+            catch (const std::out_of_range &ex)
+            {
+                LOG(WARNING) << "Invalid reference in type cache " << m_filename << ": " << ex.what();
+            }
+            return false;
+        }
+
+        void TypeCacheFile::store(const nlohmann::json &cacheKey, const TypeMap_t &typeMap, const NameToId_t &nameToId) const
+        {
+            // Each node and child list gets an index on first sight, the type graph contains shared lists and cycles
+            std::map<const ModelOpcUa::StructureNode *, std::size_t> nodeIndices;
+            std::vector<std::shared_ptr<ModelOpcUa::StructureNode>> nodes;
+            auto nodeIndex = [&](const std::shared_ptr<ModelOpcUa::StructureNode> &node) {
+                auto it = nodeIndices.find(node.get());
+                if (it != nodeIndices.end())
+                {
+                    return it->second;
+                }
+                nodeIndices.emplace(node.get(), nodes.size());
+                nodes.push_back(node);
+                return nodes.size() - 1;
+            };
+
+            nlohmann::json jsonTypeMap = nlohmann::json::array();
+            for (const auto &type : typeMap)
+            {
+                jsonTypeMap.push_back(nlohmann::json::array({nodeIdToJson(type.first.nodeId()), nodeIndex(type.second)}));
+            }
+
+            std::map<const ChildList_t *, std::size_t> listIndices;
+            nlohmann::json jsonLists = nlohmann::json::array();
+            nlohmann::json jsonNodes = nlohmann::json::array();
+            // nodes grows while the child lists are visited
+            for (std::size_t i = 0; i < nodes.size(); ++i)
+            {
+                auto node = nodes[i];
+                nlohmann::json jsonChildList;
+                if (node->SpecifiedChildNodes)
+                {
+                    auto it = listIndices.find(node->SpecifiedChildNodes.get());
+                    if (it != listIndices.end())
+                    {
+                        jsonChildList = it->second;
+                    }
+                    else
+                    {
+                        std::size_t listIndex = jsonLists.size();
+                        listIndices.emplace(node->SpecifiedChildNodes.get(), listIndex);
+                        nlohmann::json jsonList = nlohmann::json::array();
+                        for (const auto &child : *node->SpecifiedChildNodes)
+                        {
+                            jsonList.push_back(nodeIndex(child));
+                        }
+                        jsonLists.push_back(std::move(jsonList));
+                        jsonChildList = listIndex;
+                    }
+                }
+
+                jsonNodes.push_back(nlohmann::json::array({
+                    static_cast<unsigned int>(node->NodeClass),
+                    static_cast<unsigned int>(node->ModellingRule),
+                    nodeIdToJson(node->ReferenceType),
+                    nodeIdToJson(node->SpecifiedTypeNodeId),
+                    nlohmann::json::array({node->SpecifiedBrowseName.Uri, node->SpecifiedBrowseName.Name}),
+                    node->ofBaseDataVariableType,
+                    jsonChildList}));
+            }
+
+            nlohmann::json jsonNameToId = nlohmann::json::array();
+            for (const auto &name : nameToId)
+            {
+                jsonNameToId.push_back(nlohmann::json::array({name.first, nodeIdToJson(name.second)}));
+            }
+
+            nlohmann::json cache = {
+                {"Version", FormatVersion},
+                {"Key", cacheKey},
+                {"Nodes", std::move(jsonNodes)},
+                {"Lists", std::move(jsonLists)},
+                {"TypeMap", std::move(jsonTypeMap)},
+                {"NameToId", std::move(jsonNameToId)}};
+            auto content = nlohmann::json::to_cbor(cache);
+
+            // Write to a temporary file first, a crash while writing must not leave a truncated cache behind
+            std::string tmpFilename = m_filename + ".tmp";
+            {
+                std::ofstream file(tmpFilename, std::ios::binary | std::ios::trunc);
+                file.write(reinterpret_cast<const char *>(content.data()), static_cast<std::streamsize>(content.size()));
+                if (!file)
+                {
+                    LOG(WARNING) << "Unable to write type cache " << tmpFilename;
+                    return;
+                }
+            }
+            std::remove(m_filename.c_str());
+            if (std::rename(tmpFilename.c_str(), m_filename.c_str()) != 0)
+            {
+                LOG(WARNING) << "Unable to replace type cache " << m_filename;
+                return;
+            }
+            LOG(INFO) << "Stored " << typeMap.size() << " types (" << content.size() << " bytes) in type cache " << m_filename;
+        }
+    } // namespace Dashboard
+} // namespace Umati
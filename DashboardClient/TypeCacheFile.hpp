@@ -0,0 +1,43 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include <ModelOpcUa/InternedNodeId.hpp>
+#include <ModelOpcUa/ModelInstance.hpp>
+#include <nlohmann/json.hpp>
+
+namespace Umati
+{
+    namespace Dashboard
+    {
+        /**
+         * Stores the type map created by the OpcUaTypeReader in a binary (CBOR) file.
+         * Nodes and child lists shared between types are stored once and shared again after loading.
+         * A file is only used if it was written with the same format version and cache key.
+         */
+        class TypeCacheFile
+        {
+        public:
+            typedef ModelOpcUa::NodeIdMap_t<std::shared_ptr<ModelOpcUa::StructureNode>> TypeMap_t;
+            typedef std::map<std::string, ModelOpcUa::NodeId_t> NameToId_t;
+
+            /// Increment on every change of the file layout
+            static constexpr int FormatVersion = 1;
+
+            explicit TypeCacheFile(std::string filename);
+
+            /// \return false if the file does not exist, can not be parsed or belongs to another cacheKey
+            bool load(const nlohmann::json &cacheKey, TypeMap_t &typeMap, NameToId_t &nameToId) const;
+
+            void store(const nlohmann::json &cacheKey, const TypeMap_t &typeMap, const NameToId_t &nameToId) const;
+
+        protected:
+            std::string m_filename;
+        };
+    } // namespace Dashboard
+} // namespace Umati
@@ -8,8 +8,10 @@
  */
 
 #include "DashboardOpcUaClient.hpp"
+#include <future>
 
-DashboardOpcUaClient::DashboardOpcUaClient(std::shared_ptr<Umati::Util::Configuration> configuration, std::function<void()> issueReset):
+DashboardOpcUaClient::DashboardOpcUaClient(std::shared_ptr<Umati::Util::Configuration> configuration, std::function<void()> issueReset,
+                                           std::shared_ptr<Umati::OpcUa::SuperTypeCache> superTypeCache):
 m_issueReset(issueReset),
 m_opcUaWrapper(std::make_shared<Umati::OpcUa::OpcUaWrapper>()),
 m_pClient(std::make_shared<Umati::OpcUa::OpcUaClient>(
@@ -20,7 +22,10 @@ m_pClient(std::make_shared<Umati::OpcUa::OpcUaClient>(
         configuration->getOpcUa().Security,
         configuration->getObjectTypeNamespaces(),
         m_opcUaWrapper,
-        configuration->getOpcUa().ByPassCertVerification
+        configuration->getOpcUa().ByPassCertVerification,
+        configuration->getOpcUa().BrowsePageSize,
+        configuration->getOpcUa().MaxMonitoredItemsPerCall,
+        std::move(superTypeCache)
         )),
 m_pPublisher(std::make_shared<Umati::MqttPublisher_Paho::MqttPublisher_Paho>(
         configuration->getMqtt().Protocol,
@@ -28,15 +33,36 @@ m_pPublisher(std::make_shared<Umati::MqttPublisher_Paho::MqttPublisher_Paho>(
         configuration->getMqtt().Port,
         configuration->getMqtt().Username,
         configuration->getMqtt().Password)),
+m_pQueuedPublisher(std::make_shared<Umati::Dashboard::QueuedPublisher>(
+        m_pPublisher,
+        configuration->getMqtt().PublishQueueWarnSize)),
 m_pOpcUaTypeReader(std::make_shared<Umati::Dashboard::OpcUaTypeReader>(
         m_pClient,
         configuration->getObjectTypeNamespaces(),
-        configuration->getNamespaceInformations())),
-    m_machinesFilter(configuration->getMachinesFilter())
+        configuration->getNamespaceInformations(),
+        configuration->getOpcUa().TypeCacheFile)),
+    m_machinesFilter(configuration->getMachinesFilter()),
+    m_publishPatches(configuration->getMqtt().PublishPatches),
+    m_publishMinInterval(configuration->getMqtt().PublishMinInterval),
+    m_maxParallelMachineBuilds(configuration->getOpcUa().MaxParallelMachineBuilds),
+    m_machineFullUpdateInterval(configuration->getOpcUa().MachineFullUpdateInterval),
+    m_prefetchSuperTypes(configuration->getOpcUa().PrefetchSuperTypes)
 {
 
 }
 
+DashboardOpcUaClient::~DashboardOpcUaClient() {
+    m_connectionScheduler.stop();
+    m_scheduler.stop();
+    // Stop the machine update thread while the scheduler can still be triggered by value changes.
+    // Its workers might wait for asynchronous responses, keep processing them until it stopped.
+    auto observerStopped = std::async(std::launch::async, [this]() { m_pMachineObserver.reset(); });
+    while (observerStopped.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        Iterate();
+    }
+}
+
 bool DashboardOpcUaClient::connect(std::atomic_bool &running) {
     std::size_t i = 0;
     while (running && !m_pClient->isConnected() && i < 60)
@@ -50,40 +76,56 @@ bool DashboardOpcUaClient::connect(std::atomic_bool &running) {
 
 void DashboardOpcUaClient::ReadTypes() {
     m_pOpcUaTypeReader->readTypes();
+    if (m_prefetchSuperTypes) {
+        try {
+            m_pClient->prefetchSubtypes({Umati::Dashboard::NodeId_BaseObjectType, Umati::Dashboard::NodeId_BaseVariableType});
+        } catch (const std::exception &ex) {
+            LOG(WARNING) << "Prefetching supertypes failed: " << ex.what();
+        }
+    }
 }
 
 void DashboardOpcUaClient::StartMachineObserver() {
+    // Periodic publish for the republish cadence, value changes trigger an earlier publish.
+    // Registered before the observer exists, as value changes might be reported as soon as it subscribes.
+    m_publishTask = m_scheduler.addPeriodic(
+        std::chrono::milliseconds(900),
+        [this]() { m_pMachineObserver->PublishAll(); },
+        m_publishMinInterval);
+    // Own worker, the synchronous read must not delay publishing
+    m_connectionScheduler.addPeriodic(std::chrono::seconds(30), [this]() {
+        if(!m_pClient->VerifyConnection()) {
+            m_issueReset();
+        }
+    });
+
     m_pMachineObserver = std::make_shared<Umati::MachineObserver::DashboardMachineObserver>(
         m_pClient,
-        m_pPublisher,
+        m_pQueuedPublisher,
         m_pOpcUaTypeReader,
-        m_machinesFilter);
-    m_lastPublish = std::chrono::steady_clock::now();
-    m_lastConnectionVerify = std::chrono::steady_clock::now();
+        m_machinesFilter,
+        m_publishPatches,
+        [this]() { m_scheduler.trigger(m_publishTask); },
+        m_maxParallelMachineBuilds,
+        m_machineFullUpdateInterval);
+    m_scheduler.start();
+    m_connectionScheduler.start();
 }
 
 void DashboardOpcUaClient::Iterate() {
+    UA_StatusCode retval;
     {
-        std::lock_guard<std::recursive_mutex> l(m_pClient->m_clientMutex);
-        auto retval = UA_Client_run_iterate(m_pClient->m_pClient.get(), 100);
+        // Returns as soon as a message was processed or after the timeout
+        std::lock_guard<decltype(m_pClient->m_clientMutex)> l(m_pClient->m_clientMutex);
+        retval = UA_Client_run_iterate(m_pClient->m_pClient.get(), 100);
     }
-
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-
-    auto currentTime = std::chrono::steady_clock::now();
-    auto pudDiff_ms = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - m_lastPublish).count();
-    if (pudDiff_ms > 900)
+    if (UA_StatusCode_isBad(retval))
     {
-        m_lastPublish = currentTime;
-        m_pMachineObserver->PublishAll();
+        // Avoid a busy loop while the connection is down
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
 
-    auto diffConnVerify_ms = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - m_lastConnectionVerify).count();
-    if (diffConnVerify_ms > 30000)
-    {
-        m_lastConnectionVerify = currentTime;
-        if(!m_pClient->VerifyConnection()) {
-            m_issueReset();
-        }
-    }
+    // Hand the client over to threads waiting for a service call. The turn is bounded,
+    // so a steady stream of service calls does not stall the network loop.
+    m_pClient->m_clientMutex.waitWhileWaiters(std::chrono::milliseconds(100));
 }
@@ -14,25 +14,42 @@
 #include <DashboardMachineObserver.hpp>
 #include "Util/Configuration.hpp"
 #include "MachineObserver/Topics.hpp"
+#include <QueuedPublisher.hpp>
 #include <memory>
 #include <functional>
+#include <Scheduler.hpp>
 
 class DashboardOpcUaClient {
 public:
-    DashboardOpcUaClient(std::shared_ptr<Umati::Util::Configuration> configuration, std::function<void()> issueReset);
+    /// superTypeCache is kept by the caller, so that it survives resets
+    DashboardOpcUaClient(std::shared_ptr<Umati::Util::Configuration> configuration, std::function<void()> issueReset,
+                         std::shared_ptr<Umati::OpcUa::SuperTypeCache> superTypeCache = nullptr);
+    ~DashboardOpcUaClient();
 
     bool connect(std::atomic_bool &running);
     void ReadTypes();
     void StartMachineObserver();
+    /// Drives the client network loop, asynchronous responses are processed here
     void Iterate();
 protected:
     std::function<void()> m_issueReset;
     std::shared_ptr<Umati::OpcUa::OpcUaInterface> m_opcUaWrapper;
     std::shared_ptr<Umati::OpcUa::OpcUaClient> m_pClient;
     std::shared_ptr<Umati::MqttPublisher_Paho::MqttPublisher_Paho> m_pPublisher;
+    /// Forwards to m_pPublisher, so the MQTT I/O does not block serialization
+    std::shared_ptr<Umati::Dashboard::QueuedPublisher> m_pQueuedPublisher;
     std::shared_ptr<Umati::Dashboard::OpcUaTypeReader> m_pOpcUaTypeReader;
     std::shared_ptr<Umati::MachineObserver::DashboardMachineObserver> m_pMachineObserver;
-    std::chrono::time_point<std::chrono::steady_clock> m_lastPublish;
-    std::chrono::time_point<std::chrono::steady_clock> m_lastConnectionVerify;
     std::vector<ModelOpcUa::NodeId_t> m_machinesFilter;
+    bool m_publishPatches;
+    std::chrono::milliseconds m_publishMinInterval;
+    std::size_t m_maxParallelMachineBuilds;
+    std::chrono::seconds m_machineFullUpdateInterval;
+    bool m_prefetchSuperTypes;
+
+    /// Runs publishing independent of the OPC UA network loop in Iterate
+    Umati::Util::Scheduler m_scheduler;
+    Umati::Util::Scheduler::TaskId_t m_publishTask = 0;
+    /// Runs the connection verification
+    Umati::Util::Scheduler m_connectionScheduler;
 };
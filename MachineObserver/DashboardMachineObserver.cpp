@@ -13,6 +13,8 @@
 #include <easylogging++.h>
 #include "Exceptions/MachineInvalidException.hpp"
 #include <Exceptions/OpcUaException.hpp>
+#include <algorithm>
+#include <future>
 #include <utility>
 #include <Topics.hpp>
 #include <IdEncode.hpp>
@@ -27,9 +29,15 @@ namespace Umati
 			std::shared_ptr<Dashboard::IDashboardDataClient> pDataClient,
 			std::shared_ptr<Umati::Dashboard::IPublisher> pPublisher,
 			std::shared_ptr<Umati::Dashboard::OpcUaTypeReader> pOpcUaTypeReader,
-			std::vector<ModelOpcUa::NodeId_t> machinesFilter)
-			:MachineObserver(std::move(pDataClient), std::move(pOpcUaTypeReader), std::move(machinesFilter)),
-								m_pPublisher(std::move(pPublisher))
+			std::vector<ModelOpcUa::NodeId_t> machinesFilter,
+			bool publishPatches,
+			std::function<void()> onValueChanged,
+			std::size_t maxParallelMachineBuilds,
+			std::chrono::seconds fullUpdateInterval)
+			:MachineObserver(std::move(pDataClient), std::move(pOpcUaTypeReader), std::move(machinesFilter), maxParallelMachineBuilds),
+								m_fullUpdateInterval(fullUpdateInterval),
+								m_pPublisher(std::move(pPublisher)), m_publishPatches(publishPatches),
+								m_onValueChanged(std::move(onValueChanged))
 		{
 			startUpdateMachineThread();
 		}
@@ -37,6 +45,21 @@ namespace Umati
 		DashboardMachineObserver::~DashboardMachineObserver()
 		{
 			stopMachineUpdateThread();
+			if (m_modelChangeSubscription)
+			{
+				// Release the callback, it refers to this observer
+				m_pDataClient->Unsubscribe({m_modelChangeSubscription->getMonitoredItemId()},
+										   {m_modelChangeSubscription->getClientHandle()});
+			}
+			std::vector<ModelOpcUa::NodeId_t> identifiedMachines;
+			for (const auto &identificationNodes : m_identificationNodes)
+			{
+				identifiedMachines.push_back(identificationNodes.first);
+			}
+			for (const auto &machineNodeId : identifiedMachines)
+			{
+				eraseIdentificationNodes(machineNodeId);
+			}
 		}
 
 		void DashboardMachineObserver::PublishAll()
@@ -49,13 +72,11 @@ namespace Umati
 				}
 			}
 
-			// Publish online machines every 30th publish
-			if (++m_publishMachinesOnline >= 30)
+			// The machine list is published retained, it is only sent again when it changed
+			if (m_machinesListChanged.exchange(false))
 			{
 				this->publishMachinesList();
-				m_publishMachinesOnline = 0;
 			}
-
 		}
 
 		void DashboardMachineObserver::startUpdateMachineThread()
@@ -67,25 +88,92 @@ namespace Umati
 			}
 
 			auto func = [this]() {
-				int cnt = 0;
+				this->subscribeModelChanges();
+				auto nextFullUpdate = std::chrono::steady_clock::now();
 				while (this->m_running)
 				{
-					if ((cnt % 10) == 0)
+					std::set<ModelOpcUa::NodeId_t> changedNodes;
+					bool fullUpdate;
+					{
+						std::lock_guard<decltype(m_updateMachineThread_mutex)> l(m_updateMachineThread_mutex);
+						changedNodes.swap(m_changedNodes);
+						fullUpdate = !m_modelChangeSubscription || m_updateMachinesRequested || m_unknownModelChange ||
+									 std::chrono::steady_clock::now() >= nextFullUpdate;
+						m_updateMachinesRequested = false;
+						m_unknownModelChange = false;
+					}
+					if (fullUpdate || !this->UpdateChangedMachines(changedNodes))
 					{
 						this->UpdateMachines();
+						nextFullUpdate = std::chrono::steady_clock::now() + m_fullUpdateInterval;
 					}
 
-					++cnt;
-					std::this_thread::sleep_for(std::chrono::seconds(1));
+					std::unique_lock<decltype(m_updateMachineThread_mutex)> ul(m_updateMachineThread_mutex);
+					// Changes reported meanwhile are handled together, a burst of events causes a single update
+					m_updateMachineThread_condition.wait_for(ul, std::chrono::seconds(10), [this]() {
+						return !this->m_running || m_updateMachinesRequested;
+					});
+					if (m_modelChangeSubscription)
+					{
+						m_updateMachineThread_condition.wait_until(ul, nextFullUpdate, [this]() {
+							return !this->m_running || m_updateMachinesRequested || m_unknownModelChange || !m_changedNodes.empty();
+						});
+					}
 				}
 			};
 			m_running = true;
 			m_updateMachineThread = std::thread(func);
 		}
 
+		void DashboardMachineObserver::subscribeModelChanges()
+		{
+			m_modelChangeSubscription = m_pDataClient->SubscribeModelChanges(
+				[this](const std::vector<Dashboard::IDashboardDataClient::ModelChange_t> &changes) {
+					this->onModelChanges(changes);
+				});
+			if (m_modelChangeSubscription)
+			{
+				LOG(INFO) << "Server reports model changes, searching all machines every "
+						  << m_fullUpdateInterval.count() << "s only";
+			}
+			else
+			{
+				LOG(INFO) << "Server does not report model changes, searching machines periodically";
+			}
+		}
+
+		void DashboardMachineObserver::onModelChanges(const std::vector<Dashboard::IDashboardDataClient::ModelChange_t> &changes)
+		{
+			{
+				std::lock_guard<decltype(m_updateMachineThread_mutex)> l(m_updateMachineThread_mutex);
+				if (changes.empty())
+				{
+					m_unknownModelChange = true;
+				}
+				for (const auto &change : changes)
+				{
+					m_changedNodes.insert(change.Affected);
+				}
+			}
+			m_updateMachineThread_condition.notify_one();
+		}
+
+		void DashboardMachineObserver::triggerUpdateMachines()
+		{
+			{
+				std::lock_guard<decltype(m_updateMachineThread_mutex)> l(m_updateMachineThread_mutex);
+				m_updateMachinesRequested = true;
+			}
+			m_updateMachineThread_condition.notify_one();
+		}
+
 		void DashboardMachineObserver::stopMachineUpdateThread()
 		{
-			m_running = false;
+			{
+				std::lock_guard<decltype(m_updateMachineThread_mutex)> l(m_updateMachineThread_mutex);
+				m_running = false;
+			}
+			m_updateMachineThread_condition.notify_all();
 			if (m_updateMachineThread.joinable())
 			{
 				m_updateMachineThread.join();
@@ -94,6 +182,11 @@ namespace Umati
 
 		void DashboardMachineObserver::publishMachinesList()
 		{
+			decltype(m_invalidMachines) invalidMachines;
+			{
+				std::lock_guard<decltype(m_machines_mutex)> l(m_machines_mutex);
+				invalidMachines = m_invalidMachines;
+			}
 			std::unique_lock<decltype(m_dashboardClients_mutex)> ul_machines(m_dashboardClients_mutex);
 			std::unique_lock<decltype(m_machineIdentificationsCache_mutex)> ul(m_machineIdentificationsCache_mutex);
 			PublishMachinesList pubList(m_pPublisher, m_pOpcUaTypeReader->m_expectedObjectTypeNames, Topics::List);
@@ -111,7 +204,7 @@ namespace Umati
             pubList.Publish();
             auto errors = std::vector<std::string>{"errors"};
             PublishMachinesList pubInvalidList(m_pPublisher, errors, Topics::ErrorList);
-            for (auto &machineInvalid: m_invalidMachines)
+            for (auto &machineInvalid: invalidMachines)
             {
                 auto it = m_machineIdentificationsCache.find(machineInvalid.first);
                 if(it == m_machineIdentificationsCache.end() || it->second.empty()) {
@@ -142,7 +235,8 @@ namespace Umati
 				LOG(INFO) << "New Machine: " << machine.BrowseName.Name << " NodeId:"
 						  << static_cast<std::string>(machine.NodeId);
 
-				auto pDashClient = std::make_shared<Umati::Dashboard::DashboardClient>(m_pDataClient, m_pPublisher, m_pOpcUaTypeReader);
+				auto pDashClient = std::make_shared<Umati::Dashboard::DashboardClient>(m_pDataClient, m_pPublisher, m_pOpcUaTypeReader,
+																							m_onValueChanged);
 				MachineInformation_t machineInformation;
 				machineInformation.NamespaceURI = machine.NodeId.Uri;
 				machineInformation.StartNodeId = machine.NodeId;
@@ -159,25 +253,26 @@ namespace Umati
 
 				std::shared_ptr<ModelOpcUa::StructureNode> p_type = m_pOpcUaTypeReader->typeDefinitionToStructureNode(machine.TypeDefinition);
 				machineInformation.Specification = p_type->SpecifiedBrowseName.Name;
-                auto it = m_dashboardClients.find(machine.NodeId);
-                if (it != m_dashboardClients.end())
-                {
-                    it->second->Unsubscribe(machine.NodeId);
-                    m_dashboardClients.erase(it);
-                    LOG(INFO) << "Removed Machine with duplicated reference to parent with NodeId:"
-                              << static_cast<std::string>(machine.NodeId);
-                }
-
                 pDashClient->addDataSet(
 					{machineInformation.NamespaceURI, machine.NodeId.Id},
 					p_type,
 					Topics::Machine(p_type, static_cast<std::string>(machine.NodeId)),
-					Topics::OnlineStatus(static_cast<std::string>(machine.NodeId)));
+					Topics::OnlineStatus(static_cast<std::string>(machine.NodeId)),
+					m_publishPatches ? Topics::MachinePatch(p_type, static_cast<std::string>(machine.NodeId)) : std::string());
 
 				LOG(INFO) << "Read model finished";
 
+				// Machines might be built in parallel, replace a duplicate and publish the new one in a single step
 				{
 					std::unique_lock<decltype(m_dashboardClients_mutex)> ul(m_dashboardClients_mutex);
+					auto it = m_dashboardClients.find(machine.NodeId);
+					if (it != m_dashboardClients.end())
+					{
+						it->second->Unsubscribe(machine.NodeId);
+						m_dashboardClients.erase(it);
+						LOG(INFO) << "Removed Machine with duplicated reference to parent with NodeId:"
+								  << static_cast<std::string>(machine.NodeId);
+					}
 					m_dashboardClients.insert(std::make_pair(machine.NodeId, pDashClient));
 					m_onlineMachines.insert(std::make_pair(machine.NodeId, machineInformation));
 					m_machineNames.insert(std::make_pair(machine.NodeId, machine.BrowseName.Name));
@@ -195,8 +290,12 @@ namespace Umati
 
 		void DashboardMachineObserver::removeMachine(ModelOpcUa::NodeId_t machineNodeId)
 		{
+			eraseIdentificationNodes(machineNodeId);
+			{
+				std::lock_guard<decltype(m_machines_mutex)> l(m_machines_mutex);
+				m_knownMachines.erase(machineNodeId);
+			}
 			std::unique_lock<decltype(m_dashboardClients_mutex)> ul(m_dashboardClients_mutex);
-			m_knownMachines.erase(machineNodeId);
 
 			LOG(INFO) << "Remove Machine with NodeId:"
 					  << static_cast<std::string>(machineNodeId);
@@ -229,70 +328,338 @@ namespace Umati
 			nlohmann::json &identificationAsJson,
 			const ModelOpcUa::NodeId_t &typeDefinition)
 		{
+			// Used for single machines, e.g. after their model changed, the identification is browsed again
+			eraseIdentificationNodes(machineNodeId);
 			try
-			{	
-				std::shared_ptr<ModelOpcUa::StructureNode> p_type = m_pOpcUaTypeReader->getIdentificationTypeStructureNode(typeDefinition);
-				std::string typeName = p_type->SpecifiedBrowseName.Uri + ";" + p_type->SpecifiedBrowseName.Name;
-				auto typeIt = m_pOpcUaTypeReader->m_nameToId->find(typeName);
-				/// \todo Should be p_Type.specifiedTypeId ?
-				if (typeIt != m_pOpcUaTypeReader->m_nameToId->end())
+			{
+				auto pIdentificationNodes = identificationNodes(machineNodeId, typeDefinition);
+				if (pIdentificationNodes)
 				{
-					ModelOpcUa::NodeId_t type = typeIt->second;
-
-					std::list<ModelOpcUa::BrowseResult_t> identification =
-						m_pDataClient->BrowseHasComponent(machineNodeId, type);
-					if (!identification.empty())
+					auto identificationListValues = m_pDataClient->ReadeNodeValues(pIdentificationNodes->NodeIds);
+					if (!hasIdentificationValues(identificationListValues))
 					{
-						LOG(DEBUG) << "Found component of type " << type.Uri << ";" << type.Id << " in "
-								   << machineNodeId.Uri << ";" << machineNodeId.Id;
+						LOG(INFO) << "No identification values of '" << static_cast<std::string>(machineNodeId) << "'";
+						return false;
+					}
+					identificationValuesToJson(machineNodeId, typeDefinition, pIdentificationNodes->Keys, identificationListValues,
+											   identificationAsJson);
+					if (!identificationAsJson.empty())
+					{
+						return true;
+					}
+					else
+					{
+						LOG(DEBUG) << "Identification JSON empty";
+					}
+				}
+			}
+			catch (std::exception &ex)
+			{
+				LOG(ERROR) << ex.what();
+			}
+			return false;
+		}
 
-						browseIdentificationValues(machineNodeId, typeDefinition, identification.front(),
-												   identificationAsJson);
-						if (!identificationAsJson.empty())
+		std::map<ModelOpcUa::NodeId_t, nlohmann::json>
+		DashboardMachineObserver::identifyOnlineMachines(const std::list<ModelOpcUa::BrowseResult_t> &machineList)
+		{
+			// Identification nodes are only browsed and subscribed for new machines. The values of machines
+			// without complete subscribed values are read at once.
+			std::map<ModelOpcUa::NodeId_t, nlohmann::json> identifications;
+			std::vector<const ModelOpcUa::BrowseResult_t *> identifiedMachines;
+			std::list<ModelOpcUa::NodeId_t> allIdentificationNodes;
+			for (const auto &machine : machineList)
+			{
+				try
+				{
+					auto pIdentificationNodes = identificationNodes(machine.NodeId, machine.TypeDefinition);
+					if (pIdentificationNodes)
+					{
+						std::vector<nlohmann::json> subscribedValues;
+						if (subscribedIdentificationValues(machine.NodeId, subscribedValues))
 						{
-							return true;
+							nlohmann::json identificationAsJson;
+							identificationValuesToJson(machine.NodeId, machine.TypeDefinition, pIdentificationNodes->Keys,
+													   subscribedValues, identificationAsJson);
+							identifications.insert(std::make_pair(machine.NodeId, identificationAsJson));
+							continue;
 						}
-						else
+						identifiedMachines.push_back(&machine);
+						allIdentificationNodes.insert(allIdentificationNodes.end(),
+													  pIdentificationNodes->NodeIds.begin(), pIdentificationNodes->NodeIds.end());
+					}
+				}
+				catch (std::exception &ex)
+				{
+					LOG(ERROR) << ex.what();
+				}
+			}
+
+			if (identifiedMachines.empty())
+			{
+				return identifications;
+			}
+
+			std::vector<nlohmann::json> allIdentificationValues;
+			try
+			{
+				auto allRead = m_pDataClient->ReadAsync(allIdentificationNodes);
+				allIdentificationValues = Dashboard::IDashboardDataClient::waitForResult(allRead);
+			}
+			catch (const std::exception &ex)
+			{
+				LOG(INFO) << "Reading the identification of all machines failed, reading them one by one: " << ex.what();
+				allIdentificationValues.clear();
+			}
+			const bool readAll = allIdentificationValues.size() == allIdentificationNodes.size();
+
+			// A machine that fails its read does not fail the others, all single reads are in flight together
+			std::vector<std::future<std::vector<nlohmann::json>>> machineReads;
+			if (!readAll)
+			{
+				for (const auto *pMachine : identifiedMachines)
+				{
+					try
+					{
+						machineReads.push_back(m_pDataClient->ReadAsync(m_identificationNodes.at(pMachine->NodeId).NodeIds));
+					}
+					catch (...)
+					{
+						std::promise<std::vector<nlohmann::json>> failedRead;
+						failedRead.set_exception(std::current_exception());
+						machineReads.push_back(failedRead.get_future());
+					}
+				}
+			}
+
+			auto machineValuesBegin = allIdentificationValues.begin();
+			auto machineRead = machineReads.begin();
+			for (const auto *pMachine : identifiedMachines)
+			{
+				const auto &machineIdentificationNodes = m_identificationNodes.at(pMachine->NodeId);
+				std::vector<nlohmann::json> identificationListValues;
+				if (readAll)
+				{
+					auto machineValuesEnd = machineValuesBegin + machineIdentificationNodes.NodeIds.size();
+					identificationListValues.assign(machineValuesBegin, machineValuesEnd);
+					machineValuesBegin = machineValuesEnd;
+				}
+				else
+				{
+					try
+					{
+						identificationListValues = Dashboard::IDashboardDataClient::waitForResult(*machineRead++);
+					}
+					catch (const std::exception &ex)
+					{
+						LOG(INFO) << "Machine disconnected: '" << pMachine->BrowseName.Name << "' (" << ex.what() << ")";
+						// Browse again when the machine is back, its model might have changed
+						eraseIdentificationNodes(pMachine->NodeId);
+						continue;
+					}
+				}
+				// Nodes with a bad status do not fail the read, their values are null
+				if (!hasIdentificationValues(identificationListValues))
+				{
+					LOG(INFO) << "Machine disconnected: '" << pMachine->BrowseName.Name << "' (no identification values)";
+					eraseIdentificationNodes(pMachine->NodeId);
+					continue;
+				}
+
+				nlohmann::json identificationAsJson;
+				identificationValuesToJson(pMachine->NodeId, pMachine->TypeDefinition, machineIdentificationNodes.Keys,
+										   identificationListValues, identificationAsJson);
+				identifications.insert(std::make_pair(pMachine->NodeId, identificationAsJson));
+			}
+			return identifications;
+		}
+
+		const DashboardMachineObserver::IdentificationNodes_t *
+		DashboardMachineObserver::identificationNodes(const ModelOpcUa::NodeId_t &machineNodeId,
+													  const ModelOpcUa::NodeId_t &typeDefinition)
+		{
+			{
+				std::lock_guard<decltype(m_identificationNodes_mutex)> l(m_identificationNodes_mutex);
+				auto it = m_identificationNodes.find(machineNodeId);
+				if (it != m_identificationNodes.end())
+				{
+					return &it->second;
+				}
+			}
+
+			std::shared_ptr<ModelOpcUa::StructureNode> p_type = m_pOpcUaTypeReader->getIdentificationTypeStructureNode(typeDefinition);
+			std::string typeName = p_type->SpecifiedBrowseName.Uri + ";" + p_type->SpecifiedBrowseName.Name;
+			auto typeIt = m_pOpcUaTypeReader->m_nameToId->find(typeName);
+			/// \todo Should be p_Type.specifiedTypeId ?
+			if (typeIt == m_pOpcUaTypeReader->m_nameToId->end())
+			{
+				LOG(INFO) << "Unable to find type " << typeName << " in nameToId";
+				return nullptr;
+			}
+			ModelOpcUa::NodeId_t type = typeIt->second;
+
+			std::list<ModelOpcUa::BrowseResult_t> identification =
+				m_pDataClient->BrowseHasComponent(machineNodeId, type);
+			if (identification.empty())
+			{
+				LOG(INFO) << "Identification empty, couldn't find component of type " << type.Uri << ";"
+						  << type.Id << " in " << machineNodeId.Uri << ";" << machineNodeId.Id;
+				return nullptr;
+			}
+			LOG(DEBUG) << "Found component of type " << type.Uri << ";" << type.Id << " in "
+					   << machineNodeId.Uri << ";" << machineNodeId.Id;
+
+			IdentificationNodes_t nodes;
+			FillIdentificationValuesFromBrowseResult(identification.front().NodeId, nodes.NodeIds, nodes.Keys);
+			nodes.Values.resize(nodes.NodeIds.size());
+			nodes.Received.resize(nodes.NodeIds.size(), false);
+			IdentificationNodes_t *pNodes;
+			{
+				std::lock_guard<decltype(m_identificationNodes_mutex)> l(m_identificationNodes_mutex);
+				pNodes = &m_identificationNodes.insert(std::make_pair(machineNodeId, std::move(nodes))).first->second;
+			}
+
+			// Values reported before the handles are stored are already accepted by the callbacks
+			std::vector<ModelOpcUa::NodeId_t> nodeIds(pNodes->NodeIds.begin(), pNodes->NodeIds.end());
+			std::vector<Dashboard::IDashboardDataClient::newValueCallbackFunction_t> callbacks;
+			for (std::size_t i = 0; i < nodeIds.size(); ++i)
+			{
+				callbacks.emplace_back([this, machineNodeId, i](nlohmann::json value) {
+					this->onIdentificationValueChanged(machineNodeId, i, value);
+				});
+			}
+			auto subscriptions = m_pDataClient->SubscribeMany(nodeIds, callbacks, IdentificationSamplingInterval_ms);
+			{
+				std::lock_guard<decltype(m_identificationNodes_mutex)> l(m_identificationNodes_mutex);
+				pNodes->Subscriptions = std::move(subscriptions);
+			}
+			return pNodes;
+		}
+
+		bool DashboardMachineObserver::subscribedIdentificationValues(const ModelOpcUa::NodeId_t &machineNodeId,
+																	  std::vector<nlohmann::json> &values)
+		{
+			std::lock_guard<decltype(m_identificationNodes_mutex)> l(m_identificationNodes_mutex);
+			auto it = m_identificationNodes.find(machineNodeId);
+			if (it == m_identificationNodes.end())
+			{
+				return false;
+			}
+			const auto &nodes = it->second;
+			if (std::find(nodes.Received.begin(), nodes.Received.end(), false) != nodes.Received.end() ||
+				std::all_of(nodes.Values.begin(), nodes.Values.end(), [](const nlohmann::json &value) { return value.is_null(); }))
+			{
+				return false;
+			}
+			values = nodes.Values;
+			return true;
+		}
+
+		void DashboardMachineObserver::onIdentificationValueChanged(const ModelOpcUa::NodeId_t &machineNodeId, std::size_t index,
+																	const nlohmann::json &value)
+		{
+			auto hasValues = [](const IdentificationNodes_t &nodes) {
+				return std::any_of(nodes.Values.begin(), nodes.Values.end(), [](const nlohmann::json &v) { return !v.is_null(); });
+			};
+
+			bool onlineChanged = false;
+			{
+				std::lock_guard<decltype(m_identificationNodes_mutex)> l(m_identificationNodes_mutex);
+				auto it = m_identificationNodes.find(machineNodeId);
+				if (it == m_identificationNodes.end() || index >= it->second.Values.size())
+				{
+					return;
+				}
+				auto &nodes = it->second;
+				const bool wasComplete = std::find(nodes.Received.begin(), nodes.Received.end(), false) == nodes.Received.end();
+				const bool hadValues = hasValues(nodes);
+				nodes.Values[index] = value;
+				nodes.Received[index] = true;
+				// All values turning empty or back usually means that the machine went offline or online
+				onlineChanged = wasComplete && hadValues != hasValues(nodes);
+
+				std::lock_guard<decltype(m_machineIdentificationsCache_mutex)> lCache(m_machineIdentificationsCache_mutex);
+				auto cacheIt = m_machineIdentificationsCache.find(machineNodeId);
+				if (cacheIt != m_machineIdentificationsCache.end())
+				{
+					auto &data = cacheIt->second["Data"];
+					const auto &key = nodes.Keys.at(index);
+					auto valueIt = data.find(key);
+					if (value.is_null())
+					{
+						if (valueIt != data.end())
 						{
-							LOG(DEBUG) << "Identification JSON empty";
+							data.erase(valueIt);
+							m_machinesListChanged = true;
 						}
 					}
-					else
+					else if (valueIt == data.end() || *valueIt != value)
 					{
-						LOG(INFO) << "Identification empty, couldn't find component of type " << type.Uri << ";"
-								  << type.Id << " in " << machineNodeId.Uri << ";" << machineNodeId.Id;
+						data[key] = value;
+						m_machinesListChanged = true;
 					}
 				}
-				else
+			}
+
+			if (onlineChanged)
+			{
+				triggerUpdateMachines();
+			}
+		}
+
+		void DashboardMachineObserver::eraseIdentificationNodes(const ModelOpcUa::NodeId_t &machineNodeId)
+		{
+			std::vector<std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>> subscriptions;
+			{
+				std::lock_guard<decltype(m_identificationNodes_mutex)> l(m_identificationNodes_mutex);
+				auto it = m_identificationNodes.find(machineNodeId);
+				if (it == m_identificationNodes.end())
 				{
-					LOG(INFO) << "Unable to find type " << typeName << " in nameToId";
+					return;
 				}
+				subscriptions.swap(it->second.Subscriptions);
+				m_identificationNodes.erase(it);
 			}
-			catch (std::exception &ex)
+
+			// Not under m_identificationNodes_mutex, the client calls onIdentificationValueChanged while holding its own lock
+			std::vector<int32_t> monItemIds;
+			std::vector<int32_t> clientHandles;
+			for (const auto &subscription : subscriptions)
 			{
-				LOG(ERROR) << ex.what();
+				if (subscription)
+				{
+					monItemIds.push_back(subscription->getMonitoredItemId());
+					clientHandles.push_back(subscription->getClientHandle());
+				}
+			}
+			if (!monItemIds.empty())
+			{
+				try
+				{
+					m_pDataClient->Unsubscribe(monItemIds, clientHandles);
+				}
+				catch (std::exception &ex)
+				{
+					LOG(WARNING) << "Unable to unsubscribe identification of " << static_cast<std::string>(machineNodeId)
+								 << ": " << ex.what();
+				}
 			}
-			return false;
 		}
 
+		bool DashboardMachineObserver::hasIdentificationValues(const std::vector<nlohmann::json> &values)
+		{
+			return std::any_of(values.begin(), values.end(), [](const nlohmann::json &value) { return !value.is_null(); });
+		}
 
-		void DashboardMachineObserver::browseIdentificationValues(const ModelOpcUa::NodeId_t &machineNodeId, 
+		void DashboardMachineObserver::identificationValuesToJson(const ModelOpcUa::NodeId_t &machineNodeId,
 																  const ModelOpcUa::NodeId_t &typeDefinition,
-																  ModelOpcUa::BrowseResult_t &identification,
-																  nlohmann::json &identificationAsJson) const
+																  const std::vector<std::string> &identificationValueKeys,
+																  const std::vector<nlohmann::json> &identificationListValues,
+																  nlohmann::json &identificationAsJson)
 		{
-			std::vector<nlohmann::json> identificationListValues;
-			std::shared_ptr<ModelOpcUa::StructureNode> p_type = m_pOpcUaTypeReader->typeDefinitionToStructureNode(typeDefinition);			
-			std::list<ModelOpcUa::NodeId_t> identificationNodes;
-			std::vector<std::string> identificationValueKeys;
-
-			FillIdentificationValuesFromBrowseResult(
-				identification.NodeId,
-				identificationNodes,
-				identificationValueKeys);
+			std::shared_ptr<ModelOpcUa::StructureNode> p_type = m_pOpcUaTypeReader->typeDefinitionToStructureNode(typeDefinition);
 
 			nlohmann::json identificationData;
-			identificationListValues = m_pDataClient->ReadeNodeValues(identificationNodes);
 			for (size_t i = 0; i < identificationListValues.size(); i++)
 			{
 				auto value = identificationListValues.at(i);
@@ -13,6 +13,9 @@
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
 
 namespace Umati
 {
@@ -30,17 +33,30 @@ namespace Umati
 				std::shared_ptr<Dashboard::IDashboardDataClient> pDataClient,
 				std::shared_ptr<Umati::Dashboard::IPublisher> pPublisher,
 				std::shared_ptr<Umati::Dashboard::OpcUaTypeReader> pOpcUaTypeReaderm,
-				std::vector<ModelOpcUa::NodeId_t> machinesFilter);
+				std::vector<ModelOpcUa::NodeId_t> machinesFilter,
+				bool publishPatches = false,
+				std::function<void()> onValueChanged = nullptr,
+				std::size_t maxParallelMachineBuilds = 1,
+				std::chrono::seconds fullUpdateInterval = std::chrono::seconds(300));
 
 			~DashboardMachineObserver() override;
 
 			void PublishAll();
 
+			/// Run UpdateMachines now instead of waiting for the next period
+			void triggerUpdateMachines();
+
 		protected:
 			void startUpdateMachineThread();
 
 			void stopMachineUpdateThread();
 
+			/// Subscribe to model change events, machines are then only updated on changes and every m_fullUpdateInterval
+			void subscribeModelChanges();
+
+			/// Called from the OPC UA thread
+			void onModelChanges(const std::vector<Dashboard::IDashboardDataClient::ModelChange_t> &changes);
+
 			void publishMachinesList();
 
 			// Inherit from MachineObserver
@@ -53,6 +69,9 @@ namespace Umati
 				nlohmann::json &identificationAsJson,
 				const ModelOpcUa::NodeId_t &typeDefinition) override;
 
+			std::map<ModelOpcUa::NodeId_t, nlohmann::json> identifyOnlineMachines(
+				const std::list<ModelOpcUa::BrowseResult_t> &machineList) override;
+
 			struct MachineInformation_t
 			{
 				ModelOpcUa::NodeId_t StartNodeId;
@@ -63,21 +82,70 @@ namespace Umati
 				ModelOpcUa::NodeId_t Parent;
 			};
 
-			int m_publishMachinesOnline = 0;
-
 			std::atomic_bool m_running = {false};
 			std::thread m_updateMachineThread;
+			std::mutex m_updateMachineThread_mutex;
+			std::condition_variable m_updateMachineThread_condition;
+			bool m_updateMachinesRequested = false;
+			/// Nodes reported by model change events since the last update, guarded by m_updateMachineThread_mutex
+			std::set<ModelOpcUa::NodeId_t> m_changedNodes;
+			/// A model change event did not tell which nodes changed, guarded by m_updateMachineThread_mutex
+			bool m_unknownModelChange = false;
+			/// nullptr if the server does not report model changes, machines are searched periodically then
+			std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle> m_modelChangeSubscription;
+			/// Period of the full search for machines while model changes are reported
+			const std::chrono::seconds m_fullUpdateInterval;
 
 			std::shared_ptr<Umati::Dashboard::IPublisher> m_pPublisher;
+			bool m_publishPatches;
+			/// Passed to the DashboardClients, called from the OPC UA thread for every value change
+			std::function<void()> m_onValueChanged;
 			std::mutex m_dashboardClients_mutex;
-			std::map<ModelOpcUa::NodeId_t, std::shared_ptr<Umati::Dashboard::DashboardClient>> m_dashboardClients;
+			ModelOpcUa::NodeIdMap_t<std::shared_ptr<Umati::Dashboard::DashboardClient>> m_dashboardClients;
 			std::map<ModelOpcUa::NodeId_t, MachineInformation_t> m_onlineMachines;
 			std::map<ModelOpcUa::NodeId_t, std::string> m_machineNames;
 
-			void browseIdentificationValues(const ModelOpcUa::NodeId_t &machineNodeId, const ModelOpcUa::NodeId_t &typeDefinition, 
-											ModelOpcUa::BrowseResult_t &identification,
-											nlohmann::json &identificationAsJson) const;
-			///\TODO Refactor: Rename, integrate into browseIdentificationValues!?
+			/// Identification values hardly ever change, the server only samples them in this interval
+			static constexpr double IdentificationSamplingInterval_ms = 10000.0;
+
+			/// Identification variables of a machine and their BrowseNames as keys of the identification
+			struct IdentificationNodes_t
+			{
+				std::list<ModelOpcUa::NodeId_t> NodeIds;
+				std::vector<std::string> Keys;
+				/// Monitored items of NodeIds, entries are nullptr if a node could not be subscribed
+				std::vector<std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>> Subscriptions;
+				/// Last value reported by the subscription of each node, valid if Received is set
+				std::vector<nlohmann::json> Values;
+				std::vector<bool> Received;
+			};
+			/// Browsed and subscribed once per machine and reused for every check of the machine list.
+			/// Entries are only added and erased by the update thread, Values and Received are written by
+			/// the subscription callbacks. Accesses from other threads are guarded by m_identificationNodes_mutex.
+			std::map<ModelOpcUa::NodeId_t, IdentificationNodes_t> m_identificationNodes;
+			std::mutex m_identificationNodes_mutex;
+
+			/// \return the cached identification nodes, browses and subscribes them if not known yet. nullptr if the machine has no identification
+			const IdentificationNodes_t *identificationNodes(const ModelOpcUa::NodeId_t &machineNodeId, const ModelOpcUa::NodeId_t &typeDefinition);
+
+			/// Copies the subscribed identification values of a machine
+			/// \return false if not all values were received yet or all of them are empty, e.g. because the machine is offline
+			bool subscribedIdentificationValues(const ModelOpcUa::NodeId_t &machineNodeId, std::vector<nlohmann::json> &values);
+
+			/// Called from the OPC UA thread, updates the cached identification and marks the machine list as changed
+			void onIdentificationValueChanged(const ModelOpcUa::NodeId_t &machineNodeId, std::size_t index, const nlohmann::json &value);
+
+			/// Removes the cached identification nodes of a machine and deletes their monitored items
+			void eraseIdentificationNodes(const ModelOpcUa::NodeId_t &machineNodeId);
+
+			/// \return false if all values are null, e.g. because the machine is offline
+			static bool hasIdentificationValues(const std::vector<nlohmann::json> &values);
+
+			void identificationValuesToJson(const ModelOpcUa::NodeId_t &machineNodeId, const ModelOpcUa::NodeId_t &typeDefinition,
+											const std::vector<std::string> &identificationValueKeys,
+											const std::vector<nlohmann::json> &identificationListValues,
+											nlohmann::json &identificationAsJson);
+			///\TODO Refactor: Rename, integrate into identificationNodes!?
 			void FillIdentificationValuesFromBrowseResult(
 				const ModelOpcUa::NodeId_t &identificationInstance,
 				std::list<ModelOpcUa::NodeId_t> &identificationNodes,
@@ -14,6 +14,9 @@
 #include <Exceptions/MachineOfflineException.hpp>
 #include <TypeDefinition/UmatiTypeNodeIds.hpp>
 #include <utility>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 namespace Umati {
     namespace MachineObserver {
@@ -21,9 +24,11 @@ namespace Umati {
         MachineObserver::MachineObserver(
                 std::shared_ptr<Dashboard::IDashboardDataClient> pDataClient,
                 std::shared_ptr<Umati::Dashboard::OpcUaTypeReader> pTypeReader,
-                std::vector<ModelOpcUa::NodeId_t> machinesFilter
+                std::vector<ModelOpcUa::NodeId_t> machinesFilter,
+                std::size_t maxParallelMachineBuilds
         )
-                : m_pDataClient(std::move(pDataClient)), m_pOpcUaTypeReader(std::move(pTypeReader)), m_machinesFilter(machinesFilter.begin(), machinesFilter.end()) {
+                : m_pDataClient(std::move(pDataClient)), m_pOpcUaTypeReader(std::move(pTypeReader)), m_machinesFilter(machinesFilter.begin(), machinesFilter.end()),
+                  m_maxParallelMachineBuilds(std::max<std::size_t>(maxParallelMachineBuilds, 1)) {
         }
 
         MachineObserver::~MachineObserver() {}
@@ -37,9 +42,12 @@ namespace Umati {
             * Assumes that all machines are offline / to be removed
             */
             std::set<ModelOpcUa::NodeId_t> toBeRemovedMachines;
-            for(auto & knownMachine: m_knownMachines)
             {
-                toBeRemovedMachines.insert(knownMachine.first);
+                std::lock_guard<decltype(m_machines_mutex)> l(m_machines_mutex);
+                for(auto & knownMachine: m_knownMachines)
+                {
+                    toBeRemovedMachines.insert(knownMachine.second.NodeId);
+                }
             }
             std::list<ModelOpcUa::BrowseResult_t> machineList;
             /**
@@ -70,21 +78,79 @@ namespace Umati {
 
             removeOfflineMachines(toBeRemovedMachines);
 
+            std::vector<ModelOpcUa::BrowseResult_t> machinesToAdd;
             for (auto &newMachineNodeId : newMachines) {
                 // Ignore known invalid machines for a specific time
                 if (ignoreInvalidMachinesTemporarily(newMachineNodeId)) {
                     continue;
                 };
-                addNewMachine(machineList_map[newMachineNodeId]);
+                machinesToAdd.push_back(machineList_map[newMachineNodeId]);
             }
+            addNewMachines(machinesToAdd);
 
             {
                 std::unique_lock<decltype(m_machineIdentificationsCache_mutex)> ul(m_machineIdentificationsCache_mutex);
-                m_machineIdentificationsCache = machinesIdentification;
+                if (m_machineIdentificationsCache != machinesIdentification) {
+                    m_machineIdentificationsCache = machinesIdentification;
+                    m_machinesListChanged = true;
+                }
             }
 
         }
 
+        bool MachineObserver::UpdateChangedMachines(const std::set<ModelOpcUa::NodeId_t> &changedNodes) {
+            std::vector<ModelOpcUa::BrowseResult_t> changedMachines;
+            {
+                std::lock_guard<decltype(m_machines_mutex)> l(m_machines_mutex);
+                for (const auto &changedNode : changedNodes) {
+                    auto it = m_knownMachines.find(changedNode);
+                    if (it == m_knownMachines.end()) {
+                        return false;
+                    }
+                    changedMachines.push_back(it->second);
+                }
+            }
+            if (changedMachines.empty()) {
+                return true;
+            }
+
+            // The model of a changed machine is rebuilt, if it is still online
+            std::set<ModelOpcUa::NodeId_t> toBeRemovedMachines;
+            std::vector<ModelOpcUa::BrowseResult_t> machinesToAdd;
+            std::map<ModelOpcUa::NodeId_t, nlohmann::json> machinesIdentification;
+            for (const auto &machine : changedMachines) {
+                toBeRemovedMachines.insert(machine.NodeId);
+                try {
+                    nlohmann::json identificationAsJson;
+                    if (isOnline(machine.NodeId, identificationAsJson, machine.TypeDefinition)) {
+                        machinesToAdd.push_back(machine);
+                        machinesIdentification.insert(std::make_pair(machine.NodeId, identificationAsJson));
+                    } else {
+                        LOG(INFO) << "Machine " << machine.BrowseName.Name << " not identified as online";
+                    }
+                }
+                catch (const Umati::Exceptions::OpcUaException &) {
+                    LOG(INFO) << "Machine disconnected: '" << machine.BrowseName.Name << "' ("
+                              << machine.NodeId.Uri << ")";
+                }
+            }
+
+            removeOfflineMachines(toBeRemovedMachines);
+            addNewMachines(machinesToAdd);
+
+            {
+                std::unique_lock<decltype(m_machineIdentificationsCache_mutex)> ul(m_machineIdentificationsCache_mutex);
+                for (const auto &removedMachine : toBeRemovedMachines) {
+                    m_machineIdentificationsCache.erase(removedMachine);
+                }
+                for (const auto &identification : machinesIdentification) {
+                    m_machineIdentificationsCache[identification.first] = identification.second;
+                }
+            }
+            m_machinesListChanged = true;
+            return true;
+        }
+
         bool MachineObserver::machineListsNotEqual(std::list<ModelOpcUa::BrowseResult_t> &machineList) {
             /// \TODO Is this function still required? Is this handled by the reset logic?
 
@@ -112,11 +178,13 @@ namespace Umati {
         }
 
         bool MachineObserver::ignoreInvalidMachinesTemporarily(const ModelOpcUa::NodeId_t &newMachineId) {
+            std::lock_guard<decltype(m_machines_mutex)> l(m_machines_mutex);
             auto it = m_invalidMachines.find(newMachineId);
             if (it != m_invalidMachines.end()) {
                 --(it->second.first);
                 if (it->second.first <= 0) {
                     m_invalidMachines.erase(it); // todo or does it need to be it++?
+                    m_machinesListChanged = true;
                 } else {
                     return true;
                 }
@@ -164,23 +232,12 @@ namespace Umati {
         {
             std::list<ModelOpcUa::BrowseResult_t> newMachines;
             auto potentialMachines = m_pDataClient->Browse(nodeid, Dashboard::IDashboardDataClient::BrowseContext_t::Hierarchical());
+            if(filter)
+            {
+                potentialMachines.remove_if([&](const ModelOpcUa::BrowseResult_t &machine) { return !filter(machine.NodeId); });
+            }
+            fixMissingTypeDefinitions(potentialMachines);
             for(auto &machine: potentialMachines) {
-                if(filter && !filter(machine.NodeId))
-                {
-                    continue;
-                }
-                if (machine.TypeDefinition == Dashboard::NodeId_MissingType) {
-                    try {
-                        auto defs = m_pDataClient->Browse(machine.NodeId,
-                                                          Dashboard::IDashboardDataClient::BrowseContext_t::HasTypeDefinition());
-                        machine.TypeDefinition = defs.front().NodeId;
-                        LOG(INFO) << "Fixing missing type definition in opc asyncio. Parent: " << machine.NodeId
-                                  << " TypeDefinition: " << machine.TypeDefinition;
-                    }
-                    catch (const Umati::Exceptions::UmatiException &ex) {
-                        LOG(INFO) << "Could not fix missing type definition in browse result for machine " << machine.NodeId << ' ' << ex.what();
-                    }
-                }
                 try {
                     auto subTypeToBaseType = m_pOpcUaTypeReader->m_subTypeDefinitionToKnownMachineTypeDefinition.find(machine.TypeDefinition);
                     if (subTypeToBaseType == m_pOpcUaTypeReader->m_subTypeDefinitionToKnownMachineTypeDefinition.end()) {
@@ -228,28 +285,75 @@ namespace Umati {
             return newMachines;
         }
 
+        void MachineObserver::fixMissingTypeDefinitions(std::list<ModelOpcUa::BrowseResult_t> &potentialMachines)
+        {
+            std::vector<ModelOpcUa::BrowseResult_t*> machinesWithoutType;
+            std::vector<ModelOpcUa::NodeId_t> machineNodeIds;
+            for(auto &machine: potentialMachines) {
+                if (machine.TypeDefinition == Dashboard::NodeId_MissingType) {
+                    machinesWithoutType.push_back(&machine);
+                    machineNodeIds.push_back(machine.NodeId);
+                }
+            }
+            if (machinesWithoutType.empty()) {
+                return;
+            }
+
+            try {
+                auto typeDefinitions = m_pDataClient->BrowseMany(machineNodeIds,
+                                                                 Dashboard::IDashboardDataClient::BrowseContext_t::HasTypeDefinition());
+                for (std::size_t i = 0; i < machinesWithoutType.size(); ++i) {
+                    auto &machine = *machinesWithoutType[i];
+                    if (typeDefinitions[i].empty()) {
+                        LOG(INFO) << "Could not fix missing type definition in browse result for machine " << machine.NodeId;
+                        continue;
+                    }
+                    machine.TypeDefinition = typeDefinitions[i].front().NodeId;
+                    LOG(INFO) << "Fixing missing type definition in opc asyncio. Parent: " << machine.NodeId
+                              << " TypeDefinition: " << machine.TypeDefinition;
+                }
+            }
+            catch (const Umati::Exceptions::UmatiException &ex) {
+                LOG(INFO) << "Could not fix missing type definitions in browse result for machines: " << ex.what();
+            }
+        }
+
         void MachineObserver::findNewAndOfflineMachines(std::list<ModelOpcUa::BrowseResult_t> &machineList,
                                                         std::set<ModelOpcUa::NodeId_t> &toBeRemovedMachines,
                                                         std::set<ModelOpcUa::NodeId_t> &newMachines,
                                                         std::map<ModelOpcUa::NodeId_t, nlohmann::json> &machinesIdentifications) {
             LOG(INFO) << "Checking which machines are online / offline";
 
+            auto onlineMachines = identifyOnlineMachines(machineList);
             for (auto &machineTool : machineList) {
+                auto onlineMachine = onlineMachines.find(machineTool.NodeId);
+                // Machines not identified as online stay in the toBeRemovedMachines list
+                if (onlineMachine == onlineMachines.end()) {
+                    continue;
+                }
 
-                // Check if Machine is known as online machine
+                // Check if Machine is known as online machine. If so, remove it from the removed machines. If it is not on there, it must be a new machine
                 auto it = toBeRemovedMachines.find(machineTool.NodeId);
+                if (it != toBeRemovedMachines.end()) {
+                    toBeRemovedMachines.erase(it);
+                } else {
+                    newMachines.insert(machineTool.NodeId);
+                }
+                machinesIdentifications.insert(*onlineMachine);
+            }
 
-                // Machine known
+            logMachinesChanging("To be removed machines: ", toBeRemovedMachines);
+            logMachinesChanging("New / Staying machines: ", newMachines);
+        }
+
+        std::map<ModelOpcUa::NodeId_t, nlohmann::json>
+        MachineObserver::identifyOnlineMachines(const std::list<ModelOpcUa::BrowseResult_t> &machineList) {
+            std::map<ModelOpcUa::NodeId_t, nlohmann::json> identifications;
+            for (auto &machineTool : machineList) {
                 try {
-                    // Check if machine is still online. If so, remove it from the removed machines. If it is not on there, it must be a new machine
                     nlohmann::json identificationAsJson;
                     if (isOnline(machineTool.NodeId, identificationAsJson, machineTool.TypeDefinition)) {
-                        if (it != toBeRemovedMachines.end()) {
-                            toBeRemovedMachines.erase(it);// todo or does it need to be it++?
-                        } else {
-                            newMachines.insert(machineTool.NodeId);
-                        }
-                        machinesIdentifications.insert(std::make_pair(machineTool.NodeId, identificationAsJson));
+                        identifications.insert(std::make_pair(machineTool.NodeId, identificationAsJson));
                     } else {
                         LOG(INFO) << "Machine " << machineTool.BrowseName.Name << " not identified as online";
                     }
@@ -260,9 +364,7 @@ namespace Umati {
                               << machineTool.NodeId.Uri << ")";
                 }
             }
-
-            logMachinesChanging("To be removed machines: ", toBeRemovedMachines);
-            logMachinesChanging("New / Staying machines: ", newMachines);
+            return identifications;
         }
 
         void MachineObserver::logMachinesChanging(const std::string &text,
@@ -290,6 +392,7 @@ namespace Umati {
 
             for (auto &toBeRemovedMachine : toBeRemovedMachines) {
                 removeMachine(toBeRemovedMachine);
+                m_machinesListChanged = true;
             }
         }
 
@@ -297,16 +400,56 @@ namespace Umati {
         MachineObserver::addNewMachine(const ModelOpcUa::BrowseResult_t &newMachine) {
             try {
                 addMachine(newMachine);
+                std::lock_guard<decltype(m_machines_mutex)> l(m_machines_mutex);
                 m_knownMachines.insert(std::make_pair(newMachine.NodeId, newMachine));
             }
             catch (const Exceptions::MachineInvalidException &machineInvalidException) {
                 LOG(INFO) << "Machine invalid: " << static_cast<std::string>(newMachine.NodeId);
+                std::lock_guard<decltype(m_machines_mutex)> l(m_machines_mutex);
                 m_invalidMachines.insert(std::make_pair(newMachine.NodeId, std::make_pair(NumSkipAfterInvalid, machineInvalidException.what())));
             }
             catch (const Exceptions::MachineOfflineException &machineOfflineException) {
                 LOG(INFO) << "Machine offline: " << static_cast<std::string>(newMachine.NodeId);
+                std::lock_guard<decltype(m_machines_mutex)> l(m_machines_mutex);
                 m_invalidMachines.insert(std::make_pair(newMachine.NodeId, std::make_pair(NumSkipAfterInvalid, machineOfflineException.what())));
             }
+            // The machine was added either to the online machines or to the invalid machines
+            m_machinesListChanged = true;
+        }
+
+        void MachineObserver::addNewMachines(const std::vector<ModelOpcUa::BrowseResult_t> &newMachines) {
+            std::size_t numWorkers = std::min(m_maxParallelMachineBuilds, newMachines.size());
+            if (numWorkers <= 1) {
+                for (auto &newMachine : newMachines) {
+                    addNewMachine(newMachine);
+                }
+                return;
+            }
+
+            // Each worker takes the next machine not yet started, so a large machine does not hold back the others.
+            // The workers share the session. Their translate requests are asynchronous, a worker waits for its responses
+            // without holding the client lock, so the requests of all workers are in flight together.
+            std::atomic<std::size_t> nextMachine = {0};
+            auto worker = [this, &newMachines, &nextMachine]() {
+                for (std::size_t i = nextMachine++; i < newMachines.size(); i = nextMachine++) {
+                    try {
+                        addNewMachine(newMachines[i]);
+                    } catch (const std::exception &ex) {
+                        LOG(ERROR) << "Could not add machine " << static_cast<std::string>(newMachines[i].NodeId) << ": " << ex.what();
+                    }
+                }
+            };
+
+            LOG(INFO) << "Adding " << newMachines.size() << " machines using " << numWorkers << " workers";
+            std::vector<std::thread> workers;
+            workers.reserve(numWorkers - 1);
+            for (std::size_t i = 1; i < numWorkers; ++i) {
+                workers.emplace_back(worker);
+            }
+            worker();
+            for (auto &workerThread : workers) {
+                workerThread.join();
+            }
         }
     }
 }
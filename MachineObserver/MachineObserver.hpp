@@ -10,10 +10,13 @@
 #pragma once
 #include "DashboardClient.hpp"
 #include <IDashboardDataClient.hpp>
+#include <ModelOpcUa/InternedNodeId.hpp>
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <vector>
 #include <set>
+#include <cstddef>
 
 namespace Umati {
 	namespace MachineObserver {
@@ -22,7 +25,8 @@ namespace Umati {
 			MachineObserver(
 					std::shared_ptr<Dashboard::IDashboardDataClient> pDataClient,
 					std::shared_ptr<Umati::Dashboard::OpcUaTypeReader> pTypeReader,
-					std::vector<ModelOpcUa::NodeId_t> machinesFilter
+					std::vector<ModelOpcUa::NodeId_t> machinesFilter,
+					std::size_t maxParallelMachineBuilds = 1
 			);
 
 			virtual ~MachineObserver() = 0;
@@ -33,6 +37,10 @@ namespace Umati {
 		protected:
 			void UpdateMachines();
 
+			/// Check and rebuild only the given machines, e.g. after a model change event reported them
+			/// \return false if a node is not a known machine, UpdateMachines is required to find the change then
+			bool UpdateChangedMachines(const std::set<ModelOpcUa::NodeId_t> &changedNodes);
+
 			bool machineListsNotEqual(std::list<ModelOpcUa::BrowseResult_t> &machineList);
 
 			void recreateKnownMachineToolsMap(std::list<ModelOpcUa::BrowseResult_t> &machineList);
@@ -41,6 +49,9 @@ namespace Umati {
 
 			void addNewMachine(const ModelOpcUa::BrowseResult_t &newMachine);
 
+			/// Build the models of the given machines on up to m_maxParallelMachineBuilds worker threads
+			void addNewMachines(const std::vector<ModelOpcUa::BrowseResult_t> &newMachines);
+
 			void removeOfflineMachines(std::set<ModelOpcUa::NodeId_t> &toBeRemovedMachines);
 
 			bool canBrowseMachineList(std::list<ModelOpcUa::BrowseResult_t> &machineList);
@@ -60,19 +71,32 @@ namespace Umati {
 				const ModelOpcUa::NodeId_t &typeDefinition
 				) = 0;
 
+			/// \return the identification of each online machine of machineList, the default checks every machine with isOnline
+			virtual std::map<ModelOpcUa::NodeId_t, nlohmann::json> identifyOnlineMachines(
+				const std::list<ModelOpcUa::BrowseResult_t> &machineList);
+
 			std::shared_ptr<Dashboard::IDashboardDataClient> m_pDataClient;
-			std::map<ModelOpcUa::NodeId_t, ModelOpcUa::BrowseResult_t> m_knownMachines;
+			ModelOpcUa::NodeIdMap_t<ModelOpcUa::BrowseResult_t> m_knownMachines;
 			std::set<ModelOpcUa::NodeId_t> m_knownMachineToolsSet;
 			std::map<ModelOpcUa::NodeId_t, ModelOpcUa::NodeId_t> m_parentOfMachine;
 			std::shared_ptr<Umati::Dashboard::OpcUaTypeReader> m_pOpcUaTypeReader;
 			std::mutex m_machineIdentificationsCache_mutex;
 			std::map<ModelOpcUa::NodeId_t, nlohmann::json> m_machineIdentificationsCache;
+			/// Set whenever a machine is added, removed or marked invalid or its identification changed.
+			/// The machine list is only published again after it changed.
+			std::atomic_bool m_machinesListChanged = {true};
 			std::set<ModelOpcUa::NodeId_t> m_machinesFilter;
 
 			/// Blacklist of invalid machines, that will not be checked periodically
 			/// The value is decremented each time the machine would be checked and will only be added, when it reaches 0 again.
 			std::map<ModelOpcUa::NodeId_t, std::pair<int, std::string>> m_invalidMachines;
 
+			/// Maximum number of machine models built concurrently, 1 builds them one after another
+			const std::size_t m_maxParallelMachineBuilds;
+			/// Protects m_knownMachines and m_invalidMachines, they are changed by the workers of addNewMachines.
+			/// Do not acquire other locks while holding it.
+			std::mutex m_machines_mutex;
+
 			static void logMachinesChanging(const std::string &text,
 											const std::map<ModelOpcUa::NodeId_t, ModelOpcUa::BrowseResult_t> &newMachines);
 			static void logMachinesChanging(const std::string &text,
@@ -80,6 +104,8 @@ namespace Umati {
 
 			std::list<ModelOpcUa::BrowseResult_t> browseForMachines(ModelOpcUa::NodeId_t nodeid = Umati::Dashboard::NodeId_MachinesFolder, ModelOpcUa::NodeId_t parentId = Umati::Dashboard::NodeId_MachinesFolder, std::function<bool(ModelOpcUa::NodeId_t)> filter = nullptr);
 			std::list<ModelOpcUa::BrowseResult_t> findComponentsFolder(ModelOpcUa::NodeId_t nodeid);
+			/// Resolve the TypeDefinition of all machines reported with NodeId_MissingType in one batched browse
+			void fixMissingTypeDefinitions(std::list<ModelOpcUa::BrowseResult_t> &potentialMachines);
 
 		};
 	}
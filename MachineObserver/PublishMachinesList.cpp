@@ -8,6 +8,7 @@
 
 #include "PublishMachinesList.hpp"
 #include <Topics.hpp>
+#include <JsonFormat.hpp>
 
 namespace Umati
 {
@@ -31,14 +32,14 @@ namespace Umati
 				{
 					publishData.push_back(machineData);
 				}
-				m_pPublisher->Publish(m_getTopic(el.first), publishData.dump(0));
+				m_pPublisher->Publish(m_getTopic(el.first), Util::JsonFormat::Dump(publishData, 0));
 			}
 
 			for(auto spec : m_Specifications)
 			{
 				if(m_Machines.count(spec) == 0)
 				{
-					m_pPublisher->Publish(m_getTopic(spec), nlohmann::json::array().dump(0));
+					m_pPublisher->Publish(m_getTopic(spec), Util::JsonFormat::Dump(nlohmann::json::array(), 0));
 				}
 			}
 		}
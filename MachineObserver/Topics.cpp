@@ -25,6 +25,16 @@ namespace Umati
             return topic.str();
         }
 
+        std::string Topics::MachinePatch(
+            const std::shared_ptr<ModelOpcUa::StructureNode> &p_type,
+            const std::string &machineId)
+        {
+            std::string specification = p_type->SpecifiedBrowseName.Name;
+            std::stringstream topic;
+            topic << Topics::Prefix << "/" << Topics::ClientId << "/patch/" << specification << "/" << Umati::Util::IdEncode(machineId);
+            return topic.str();
+        }
+
         std::string Topics::List(const std::string &specType)
         {
             std::stringstream topic;
@@ -21,6 +21,10 @@ namespace Umati
             static std::string Machine(
                 const std::shared_ptr<ModelOpcUa::StructureNode> &p_type,
                 const std::string &machineId);
+            /// Merge patches of the document published on Machine()
+            static std::string MachinePatch(
+                const std::shared_ptr<ModelOpcUa::StructureNode> &p_type,
+                const std::string &machineId);
             static std::string List(const std::string &specType);
             static std::string ErrorList(const std::string &specType);
             static std::string OnlineStatus(const std::string &machineId);
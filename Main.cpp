@@ -31,6 +31,7 @@
 #include <atomic>
 #include <ConfigureLogger.hpp>
 #include <ConfigurationJsonFile.hpp>
+#include <JsonFormat.hpp>
 #include <Exceptions/ConfigurationException.hpp>
 #include <chrono>
 #include <iomanip>
@@ -73,6 +74,7 @@ int main(int argc, char *argv[])
 		config = std::make_shared<Umati::Util::ConfigurationJsonFile>(configFilename);
 		Umati::MachineObserver::Topics::Prefix = config->getMqtt().Prefix; 
 		Umati::MachineObserver::Topics::ClientId = config->getMqtt().ClientId; 
+		Umati::Util::JsonFormat::Compact = config->getMqtt().CompactJson;
 	}
 	catch (Umati::Util::Exception::ConfigurationException &ex)
 	{
@@ -81,13 +83,15 @@ int main(int argc, char *argv[])
 		return 1;
 	}
 
+	// Types rarely change, their supertypes are not browsed again after a reset
+	auto superTypeCache = std::make_shared<Umati::OpcUa::SuperTypeCache>(config->getOpcUa().SuperTypeCacheSize);
 	std::size_t resetCounter = 0;
 	while(running) {
 		if(reset) {
 			++resetCounter;
 			reset = false;
 		}
-		DashboardOpcUaClient dashboardClient(config, issueReset);
+		DashboardOpcUaClient dashboardClient(config, issueReset, superTypeCache);
 
 		if (!dashboardClient.connect(running))
 		{
@@ -0,0 +1,99 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "InternedNodeId.hpp"
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace ModelOpcUa
+{
+	namespace
+	{
+		struct UriTable
+		{
+			std::mutex Mutex;
+			/// A deque keeps references to its elements valid while it grows
+			std::deque<std::string> Uris;
+			std::unordered_map<std::string, NamespaceUriTable::Handle_t> Handles;
+		};
+
+		UriTable &uriTable()
+		{
+			static UriTable table;
+			return table;
+		}
+	} // namespace
+
+	NamespaceUriTable::Handle_t NamespaceUriTable::intern(const std::string &uri)
+	{
+		// Handles never change, so each thread keeps the handles it has seen and only locks the table for new URIs.
+		// Most lookups are for the namespace of the previous one.
+		thread_local const std::string *pLastUri = nullptr;
+		thread_local Handle_t lastHandle = 0;
+		thread_local std::unordered_map<std::string, Handle_t> knownHandles;
+		if (pLastUri && *pLastUri == uri)
+		{
+			return lastHandle;
+		}
+		auto known = knownHandles.find(uri);
+		if (known == knownHandles.end())
+		{
+			auto &table = uriTable();
+			std::lock_guard<std::mutex> l(table.Mutex);
+			auto it = table.Handles.find(uri);
+			Handle_t handle;
+			if (it != table.Handles.end())
+			{
+				handle = it->second;
+			}
+			else
+			{
+				handle = static_cast<Handle_t>(table.Uris.size());
+				table.Uris.push_back(uri);
+				table.Handles.emplace(uri, handle);
+			}
+			known = knownHandles.emplace(uri, handle).first;
+		}
+		pLastUri = &known->first;
+		lastHandle = known->second;
+		return lastHandle;
+	}
+
+	const std::string &NamespaceUriTable::uri(Handle_t handle)
+	{
+		thread_local std::vector<const std::string *> knownUris;
+		if (handle < knownUris.size() && knownUris[handle])
+		{
+			return *knownUris[handle];
+		}
+		auto &table = uriTable();
+		std::lock_guard<std::mutex> l(table.Mutex);
+		if (handle >= table.Uris.size())
+		{
+			throw std::out_of_range("Unknown namespace handle");
+		}
+		if (handle >= knownUris.size())
+		{
+			knownUris.resize(handle + 1, nullptr);
+		}
+		knownUris[handle] = &table.Uris[handle];
+		return table.Uris[handle];
+	}
+
+	InternedNodeId_t::InternedNodeId_t(const NodeId_t &nodeId)
+		: m_namespace(NamespaceUriTable::intern(nodeId.Uri)), m_id(nodeId.Id)
+	{
+		m_hash = std::hash<std::string>()(m_id);
+		// Same mixing as boost::hash_combine
+		m_hash ^= std::hash<NamespaceUriTable::Handle_t>()(m_namespace) + 0x9e3779b9 + (m_hash << 6) + (m_hash >> 2);
+	}
+
+	NodeId_t InternedNodeId_t::nodeId() const
+	{
+		return NodeId_t{NamespaceUriTable::uri(m_namespace), m_id};
+	}
+} // namespace ModelOpcUa
@@ -0,0 +1,96 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "ModelDefinition.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ModelOpcUa
+{
+	/**
+	 * Process wide table of namespace URIs, each URI is stored once and identified by a small handle.
+	 * URIs are never removed, a client only knows a few namespaces.
+	 * Lookups of URIs and handles a thread has seen before do not lock the table.
+	 */
+	class NamespaceUriTable
+	{
+	public:
+		typedef std::uint32_t Handle_t;
+
+		/// \return the handle of uri, the uri is added if it is unknown
+		static Handle_t intern(const std::string &uri);
+
+		/// The reference stays valid for the lifetime of the process
+		static const std::string &uri(Handle_t handle);
+	};
+
+	/**
+	 * Compact NodeId_t for keys of hash maps. The namespace URI is interned and the hash is computed once,
+	 * equal ids are compared by integers first.
+	 * Implicitly constructible from NodeId_t, so maps keyed by it are searched with NodeId_t.
+	 * Each conversion copies the id and hashes it, convert once when the same id is searched and inserted.
+	 */
+	class InternedNodeId_t
+	{
+	public:
+		InternedNodeId_t(const NodeId_t &nodeId);
+
+		NodeId_t nodeId() const;
+
+		NamespaceUriTable::Handle_t namespaceHandle() const
+		{
+			return m_namespace;
+		}
+
+		const std::string &id() const
+		{
+			return m_id;
+		}
+
+		std::size_t hash() const
+		{
+			return m_hash;
+		}
+
+		bool operator==(const InternedNodeId_t &other) const
+		{
+			return m_hash == other.m_hash && m_namespace == other.m_namespace && m_id == other.m_id;
+		}
+
+		bool operator!=(const InternedNodeId_t &other) const
+		{
+			return !(*this == other);
+		}
+
+	private:
+		NamespaceUriTable::Handle_t m_namespace;
+		std::string m_id;
+		std::size_t m_hash;
+	};
+} // namespace ModelOpcUa
+
+namespace std
+{
+	template <>
+	struct hash<ModelOpcUa::InternedNodeId_t>
+	{
+		std::size_t operator()(const ModelOpcUa::InternedNodeId_t &nodeId) const noexcept
+		{
+			return nodeId.hash();
+		}
+	};
+} // namespace std
+
+namespace ModelOpcUa
+{
+	template <typename T>
+	using NodeIdMap_t = std::unordered_map<InternedNodeId_t, T>;
+
+	typedef std::unordered_set<InternedNodeId_t> NodeIdSet_t;
+} // namespace ModelOpcUa
@@ -218,6 +218,11 @@ namespace ModelOpcUa {
 			namespaceUri(namespaceUri) {}
 
 	std::shared_ptr<StructureNode> StructureBiNode::toStructureNode() {
+		// Shared InstanceDeclarations are converted for every type using them, add the children only once
+		if (structureNodeCreated) {
+			return this->structureNode;
+		}
+		structureNodeCreated = true;
 
 		if (!this->SpecifiedBiChildNodes->empty()) {
 			for (auto childIterator = this->SpecifiedBiChildNodes->begin();
@@ -12,6 +12,7 @@
 
 #include <string>
 #include <list>
+#include <functional>
 #include <memory>
 #include <sstream>
 #include <vector>
@@ -293,6 +294,8 @@ namespace ModelOpcUa
 		std::string namespaceUri;
 		bool isType = false;
 		bool ofBaseDataVariableType = false;
+		/// Set by toStructureNode, the children are added to structureNode only once
+		bool structureNodeCreated = false;
 		std::shared_ptr<std::list<std::shared_ptr<StructureBiNode>>> SpecifiedBiChildNodes = std::make_shared<std::list<std::shared_ptr<StructureBiNode>>>();
 	};
 
@@ -316,3 +319,18 @@ namespace ModelOpcUa
 		const std::list<std::shared_ptr<const StructureNode>> PossibleTypes;
 	};
 } // namespace ModelOpcUa
+
+namespace std
+{
+	template <>
+	struct hash<ModelOpcUa::NodeId_t>
+	{
+		std::size_t operator()(const ModelOpcUa::NodeId_t &nodeId) const noexcept
+		{
+			std::size_t seed = std::hash<std::string>()(nodeId.Uri);
+			// Same mixing as boost::hash_combine
+			seed ^= std::hash<std::string>()(nodeId.Id) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			return seed;
+		}
+	};
+} // namespace std
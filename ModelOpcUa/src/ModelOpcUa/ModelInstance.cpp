@@ -28,6 +28,8 @@ namespace ModelOpcUa {
 
 	Node::~Node() = default;
 
+	constexpr std::size_t SimpleNode::NoValueSlot;
+
 	SimpleNode::SimpleNode(
 			NodeId_t nodeId,
 			NodeId_t typeNodeId,
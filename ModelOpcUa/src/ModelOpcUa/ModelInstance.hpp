@@ -51,6 +51,11 @@ namespace ModelOpcUa {
 
 		// The instanciated type of the Node (might be a subtype of the defined one)
 		NodeId_t TypeNodeId;
+
+		static constexpr std::size_t NoValueSlot = static_cast<std::size_t>(-1);
+
+		// Dense index of the value in the value store of the owning data set, NoValueSlot if no value is stored
+		std::size_t ValueSlot = NoValueSlot;
 	};
 
 	struct PlaceholderElement {
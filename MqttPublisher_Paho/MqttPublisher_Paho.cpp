@@ -79,7 +79,7 @@ namespace Umati {
 
 		void MqttPublisher_Paho::Publish(std::string channel, std::string message) {
 			try {
-				m_cli.publish(channel, message, 0, true);
+				m_cli.publish(std::move(channel), std::move(message), 0, true);
 			}
 			catch (const mqtt::exception &ex) {
 				LOG(ERROR) << "Paho Exception:" << ex.what();
@@ -0,0 +1,61 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace Umati
+{
+	namespace OpcUa
+	{
+		/**
+		 * Recursive mutex that counts the threads waiting for it.
+		 * The network loop holds the client while waiting for the socket and uses waitWhileWaiters()
+		 * to hand the client over instead of relocking it immediately.
+		 */
+		class ClientMutex
+		{
+		public:
+			void lock()
+			{
+				if (m_mutex.try_lock())
+				{
+					return;
+				}
+				++m_waiters;
+				m_mutex.lock();
+				{
+					std::lock_guard<std::mutex> l(m_waitersMutex);
+					--m_waiters;
+				}
+				m_waitersCondition.notify_all();
+			}
+
+			bool try_lock() { return m_mutex.try_lock(); }
+
+			void unlock() { m_mutex.unlock(); }
+
+			bool hasWaiters() const { return m_waiters > 0; }
+
+			/// Blocks until no thread waits for the mutex or the timeout elapsed, the caller must not hold the mutex.
+			/// \return false on timeout
+			bool waitWhileWaiters(std::chrono::milliseconds timeout)
+			{
+				std::unique_lock<std::mutex> ul(m_waitersMutex);
+				return m_waitersCondition.wait_for(ul, timeout, [this]() { return m_waiters == 0; });
+			}
+
+		private:
+			std::recursive_mutex m_mutex;
+			std::atomic_int m_waiters = {0};
+			std::mutex m_waitersMutex;
+			std::condition_variable m_waitersCondition;
+		};
+	}
+}
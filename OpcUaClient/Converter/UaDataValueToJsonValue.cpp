@@ -8,11 +8,12 @@
  */
 
 #include "UaDataValueToJsonValue.hpp"
+#include "UaValueFormat.hpp"
+#include "UaStructurePlans.hpp"
+#include "UaNumericArray.hpp"
 
 #include <easylogging++.h>
 #include <iomanip>
-#include "CustomDataTypes/types_machinery_result_generated_handling.h"
-#include "CustomDataTypes/types_tightening_generated_handling.h"
 #include "../deps/open62541/src/ua_types_encoding_binary.h"
 
 namespace Umati {
@@ -104,25 +105,13 @@ namespace Umati {
 
 					case UA_DATATYPEKIND_DATETIME: {
 						UA_DateTime dateTime(*(UA_DateTime*)variant.data);
-						auto dtStruct = UA_DateTime_toStruct(dateTime);
-						//No to String() function. Using stringstream to build the string in the right format.
-						std::stringstream dateTimeString;
-						dateTimeString << dtStruct.year << "-" << dtStruct.month << "-" << dtStruct.day << "T"
-						<< dtStruct.hour << ":" << dtStruct.min << ":" << dtStruct.sec << ":" << dtStruct.milliSec << "Z";
-
-						*jsonValue = dateTimeString.str();
+						*jsonValue = UaValueFormat::dateTimeToString(dateTime);
 						break;
 					}
 
 					case UA_DATATYPEKIND_GUID: {
 						UA_Guid guid(*(UA_Guid*) variant.data);
-						std::stringstream str;
-						str << std::hex << (uint32_t) guid.data1 
-							<< '-' << (uint16_t) guid.data2 
-							<< '-' << (uint16_t) guid.data3
-							<< '-' << *(uint32_t*) &guid.data4[0] 
-							<< '-' << *(uint32_t*) &guid.data4[4];
-						*jsonValue = str.str();
+						*jsonValue = UaValueFormat::guidToString(guid);
 						break;
 					}
 
@@ -175,129 +164,39 @@ namespace Umati {
 					case UA_DATATYPEKIND_EXTENSIONOBJECT: {
 						UA_ExtensionObject exObj(*(UA_ExtensionObject*)variant.data);
 						*jsonValue = {};
-						if (exObj.content.encoded.typeId.namespaceIndex != 0) {
-
-							if (exObj.content.encoded.typeId.identifier.numeric == 5008) {
-								size_t offset = 0;
-								UA_ResultDataType result;
-								UA_StatusCode retval = UA_decodeBinaryInternal(&exObj.content.encoded.body, &offset, &result,
-														&UA_TYPES_MACHINERY_RESULT[UA_TYPES_MACHINERY_RESULT_RESULTDATATYPE], NULL);
+						if (exObj.encoding >= UA_EXTENSIONOBJECT_DECODED) {
+							// Converted like a scalar of the decoded type
+							UA_Variant decoded;
+							UA_Variant_setScalar(&decoded, exObj.content.decoded.data, exObj.content.decoded.type);
+							setValueFromScalarVariant(decoded, jsonValue, serializeStatusInformation);
+							break;
+						}
 
-								UA_DataValue dataVal;
-								UA_DataValue_init(&dataVal);
-								nlohmann::json resultMetaDataJson = {};
-								{
-									UA_Variant_setScalar(&dataVal.value, &result.resultMetaData.resultId, &UA_TYPES[UA_TYPES_STRING]);
-									resultMetaDataJson["ResultId"] = UaDataValueToJsonValue(
-										dataVal,
-										serializeStatusInformation)
-										.getValue();
-								}
-								if (result.resultMetaData.resultState) {
-									UA_Variant_setScalar(&dataVal.value, result.resultMetaData.resultState, &UA_TYPES[UA_TYPES_INT32]);
-									resultMetaDataJson["ResultState"] = UaDataValueToJsonValue(
-										dataVal,
-										serializeStatusInformation)
-										.getValue();
-								}
-								if (result.resultMetaData.resultUri) {
-									UA_Variant_setArray(&dataVal.value, result.resultMetaData.resultUri, result.resultMetaData.resultUriSize, &UA_TYPES[UA_TYPES_STRING]);
-									resultMetaDataJson["ResultUri"] = UaDataValueToJsonValue(
-										dataVal,
-										serializeStatusInformation)
-										.getValue();
-								}
-								if (result.resultMetaData.fileFormat) {
-									UA_Variant_setArray(&dataVal.value, result.resultMetaData.fileFormat, result.resultMetaData.fileFormatSize, &UA_TYPES[UA_TYPES_STRING]);
-									resultMetaDataJson["FileFormat"] = UaDataValueToJsonValue(
-										dataVal,
-										serializeStatusInformation)
-										.getValue();
-								}
-								(*jsonValue)["ResultMetaData"] = resultMetaDataJson;
-							} else if(exObj.content.encoded.typeId.identifier.numeric == 5001 /* Encoding of ProcessingTimesDataType */) {
-								size_t offset = 0;
-								UA_IJT_ProcessingTimesDataType ptime;
-								UA_StatusCode retval = UA_decodeBinaryInternal(&exObj.content.encoded.body, &offset, &ptime,
-											&UA_TYPES_TIGHTENING[UA_TYPES_TIGHTENING_PROCESSINGTIMESDATATYPE], NULL);
-								UA_DataValue dataVal;
-								UA_DataValue_init(&dataVal);
-								if(ptime.acquisitionDuration)(*jsonValue)["AcquisitionDuration"] = *ptime.acquisitionDuration;
-								if(ptime.processingDuration)(*jsonValue)["ProcessingDuration"] = *ptime.processingDuration;
-
-								UA_Variant_setScalar(&dataVal.value, &ptime.startTime, &UA_TYPES[UA_TYPES_DATETIME]);
-								(*jsonValue)["StartTime"] = UaDataValueToJsonValue(
-									dataVal,
-									serializeStatusInformation)
-									.getValue();
-								
-								UA_Variant_setScalar(&dataVal.value, &ptime.endTime, &UA_TYPES[UA_TYPES_DATETIME]);
-								(*jsonValue)["EndTime"] = UaDataValueToJsonValue(
-									dataVal,
-									serializeStatusInformation)
-									.getValue();
+						// Registered custom structures the client did not decode, e.g. before the namespace indices were known
+						auto pPlans = UaStructurePlans::current();
+						auto pPlan = pPlans->findByEncodingId(exObj.content.encoded.typeId);
+						if (pPlan && exObj.encoding == UA_EXTENSIONOBJECT_ENCODED_BYTESTRING) {
+							size_t offset = 0;
+							void *data = UA_new(pPlan->Type);
+							UA_StatusCode retval = UA_decodeBinaryInternal(&exObj.content.encoded.body, &offset, data,
+														pPlan->Type, NULL);
+							if (retval == UA_STATUSCODE_GOOD) {
+								setValueFromStructure(*pPlan, data, jsonValue, serializeStatusInformation);
 							} else {
-								LOG(ERROR) << "Not implemented conversion from OpcUaType_ExtensionObject with custom structured data type.";
+								LOG(ERROR) << "Decoding of " << pPlan->Type->typeName << " failed: " << UA_StatusCode_name(retval);
 							}
-
+							UA_delete(data, pPlan->Type);
 							break;
 						}
 
-						switch (exObj.content.encoded.typeId.identifierType) {
-							case UA_TYPES_RANGE: {
-								UA_Range range(*(UA_Range*)exObj.content.decoded.data);
-								(*jsonValue)["low"] = range.low;
-								(*jsonValue)["high"] = range.high;
-								break;
-							}
-							case UA_TYPES_EUINFORMATION: {
-								UA_EUInformation euInfo(*(UA_EUInformation*)variant.data);
-								(*jsonValue)["namespaceUri"] = std::string((char*)euInfo.namespaceUri.data,euInfo.namespaceUri.length);
-								(*jsonValue)["unitId"] = euInfo.unitId;
-								UA_DataValue dataVal;
-								UA_DataValue_init(&dataVal);
-								{
-									UA_Variant_setScalar(&dataVal.value, &euInfo.displayName, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
-									(*jsonValue)["displayName"] = UaDataValueToJsonValue(
-										dataVal,
-										serializeStatusInformation)
-										.getValue();
-								}
-								{
-									UA_Variant_setScalar(&dataVal.value, &euInfo.description, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
-									(*jsonValue)["description"] = UaDataValueToJsonValue(
-										dataVal,
-										serializeStatusInformation)
-										.getValue();
-								}
-								break;
-							}
-
-							case UA_TYPES_GUID: {
-								UA_Guid guid(*(UA_Guid*)exObj.content.decoded.data);
-								std::stringstream str;
-								str << 		  std::hex << guid.data1 
-									<< '-' << std::hex << guid.data2 
-									<< '-' << std::hex << guid.data3
-									<< '-' << std::hex << guid.data4; 
-								(*jsonValue) = str.str();
-								break;
-							}
-
-							case UA_TYPES_TIMEZONEDATATYPE: {
-								UA_TimeZoneDataType tz(*(UA_TimeZoneDataType*)exObj.content.decoded.data);
-								(*jsonValue)["daylightSavingInOffset"] = tz.daylightSavingInOffset;
-								(*jsonValue)["offset"] = tz.offset;
-								break;
-							}
-
-							default: {
-								if (exObj.encoding == UA_EXTENSIONOBJECT_ENCODED_NOBODY) {
-									LOG(ERROR) << "Internal decoding error in open62541, might be a unknown custom datatype";
-								} else {
-									LOG(ERROR) << "Not implemented conversion from type: " << exObj.content.encoded.body.data;
-								}
-							}
+						if (exObj.encoding == UA_EXTENSIONOBJECT_ENCODED_NOBODY) {
+							LOG(ERROR) << "Internal decoding error in open62541, might be a unknown custom datatype";
+						} else if (exObj.content.encoded.typeId.namespaceIndex != 0) {
+							// The client loads the DataTypeDefinition, later values are decoded by open62541
+							UaStructurePlans::reportUnknownEncoding(exObj.content.encoded.typeId);
+							LOG(WARNING) << "Unknown custom structured data type, value skipped until its definition is loaded.";
+						} else {
+							LOG(ERROR) << "Not implemented conversion from OpcUaType_ExtensionObject with custom structured data type.";
 						}
 						break;
 					}
@@ -317,9 +216,15 @@ namespace Umati {
 						break;
 					}
 
-					case UA_DATATYPEKIND_STRUCTURE: {
+					case UA_DATATYPEKIND_ENUM: {
+						UA_Int32 v(*(UA_Int32*)variant.data);
+						*jsonValue = v;
+						break;
+					}
 
-						if(strcmp(variant.type->typeName, "EUInformation")== 0){
+					case UA_DATATYPEKIND_STRUCTURE:
+					case UA_DATATYPEKIND_OPTSTRUCT: {
+						if (variant.type == &UA_TYPES[UA_TYPES_EUINFORMATION]) {
 								UA_EUInformation euInfo(*(UA_EUInformation*)variant.data);
 								(*jsonValue)["namespaceUri"] = std::string((char*)euInfo.namespaceUri.data,euInfo.namespaceUri.length);
 								(*jsonValue)["unitId"] = euInfo.unitId;
@@ -340,81 +245,32 @@ namespace Umati {
 										.getValue();
 								}
 								break;
-						}else if (strcmp(variant.type->typeName, "Range")== 0){
+						} else if (variant.type == &UA_TYPES[UA_TYPES_RANGE]) {
 								UA_Range range(*(UA_Range*)variant.data);
 								(*jsonValue)["low"] = range.low;
 								(*jsonValue)["high"] = range.high;
 								break;
-						}else if (strcmp(variant.type->typeName, "TimeZoneDataType")== 0){
+						} else if (variant.type == &UA_TYPES[UA_TYPES_TIMEZONEDATATYPE]) {
 								UA_TimeZoneDataType tz(*(UA_TimeZoneDataType*)variant.data);
 								(*jsonValue)["daylightSavingInOffset"] = tz.daylightSavingInOffset;
 								(*jsonValue)["offset"] = tz.offset;
 								break;
-						}else{
-							LOG(ERROR) << "Unknown data type. ";
-							break;
 						}
-					}
 
-					default: {
-						if(strcmp(variant.type->typeName, UA_TYPES_TIGHTENING[UA_TYPES_TIGHTENING_PROCESSINGTIMESDATATYPE].typeName) == 0) {
-							UA_IJT_ProcessingTimesDataType ptime(*(UA_IJT_ProcessingTimesDataType*)variant.data);
-							UA_DataValue dataVal;
-							UA_DataValue_init(&dataVal);
-							if(ptime.acquisitionDuration)(*jsonValue)["AcquisitionDuration"] = *ptime.acquisitionDuration;
-							if(ptime.processingDuration)(*jsonValue)["ProcessingDuration"] = *ptime.processingDuration;
-
-							UA_Variant_setScalar(&dataVal.value, &ptime.startTime, &UA_TYPES[UA_TYPES_DATETIME]);
-							(*jsonValue)["StartTime"] = UaDataValueToJsonValue(
-								dataVal,
-								serializeStatusInformation)
-								.getValue();
-							
-							UA_Variant_setScalar(&dataVal.value, &ptime.endTime, &UA_TYPES[UA_TYPES_DATETIME]);
-							(*jsonValue)["EndTime"] = UaDataValueToJsonValue(
-								dataVal,
-								serializeStatusInformation)
-								.getValue();
-						}
-						else if (strcmp(variant.type->typeName, UA_TYPES_MACHINERY_RESULT[UA_TYPES_MACHINERY_RESULT_RESULTDATATYPE].typeName) == 0) {
-							UA_ResultDataType result(*(UA_ResultDataType*)variant.data);
-							UA_DataValue dataVal;
-							UA_DataValue_init(&dataVal);
-							nlohmann::json resultMetaDataJson = {};
-							{
-								UA_Variant_setScalar(&dataVal.value, &result.resultMetaData.resultId, &UA_TYPES[UA_TYPES_STRING]);
-								resultMetaDataJson["ResultId"] = UaDataValueToJsonValue(
-									dataVal,
-									serializeStatusInformation)
-									.getValue();
-							}
-							if (result.resultMetaData.resultState) {
-								UA_Variant_setScalar(&dataVal.value, result.resultMetaData.resultState, &UA_TYPES[UA_TYPES_INT32]);
-								resultMetaDataJson["ResultState"] = UaDataValueToJsonValue(
-									dataVal,
-									serializeStatusInformation)
-									.getValue();
-							}
-							if (result.resultMetaData.resultUri) {
-								UA_Variant_setArray(&dataVal.value, result.resultMetaData.resultUri, result.resultMetaData.resultUriSize, &UA_TYPES[UA_TYPES_STRING]);
-								resultMetaDataJson["ResultUri"] = UaDataValueToJsonValue(
-									dataVal,
-									serializeStatusInformation)
-									.getValue();
-							}
-							if (result.resultMetaData.fileFormat) {
-								UA_Variant_setArray(&dataVal.value, result.resultMetaData.fileFormat, result.resultMetaData.fileFormatSize, &UA_TYPES[UA_TYPES_STRING]);
-								resultMetaDataJson["FileFormat"] = UaDataValueToJsonValue(
-									dataVal,
-									serializeStatusInformation)
-									.getValue();
-							}
-							(*jsonValue)["ResultMetaData"] = resultMetaDataJson;
+						auto pPlans = UaStructurePlans::current();
+						auto pPlan = pPlans->findByTypeId(variant.type->typeId);
+						if (pPlan) {
+							setValueFromStructure(*pPlan, variant.data, jsonValue, serializeStatusInformation);
 						} else {
 							LOG(ERROR) << "Unknown data type. ";
 						}
 						break;
 					}
+
+					default: {
+						LOG(ERROR) << "Unknown data type. ";
+						break;
+					}
 				}
 
 			}
@@ -423,6 +279,11 @@ namespace Umati {
 			template<typename T>
 			void UaDataValueToJsonValue::getValueFromDataValueArray(const UA_Variant *variant, UA_UInt32 dimensionNumber,
 																	nlohmann::json *j, T *variantData, bool serializeStatusInformation) {
+				// Elements are addressed by memSize, so T may be void for structures without a C++ type
+				auto elementAt = [variant, variantData](std::size_t i) {
+					return static_cast<T*>(static_cast<void*>(
+						static_cast<char*>(static_cast<void*>(variantData)) + i * variant->type->memSize));
+				};
 				if (dimensionNumber == variant->arrayDimensionsSize - 1) {
 					for(int i = 0; i < variant->arrayDimensions[dimensionNumber]; i++) {
 						nlohmann::json jsonValue;
@@ -430,7 +291,7 @@ namespace Umati {
 							variant->type,  			/* The data type description */
 							variant->storageType,
 							0,           				/* The number of elements in the data array */
-							(void*) (&variantData[i]), /* Points to the scalar or array data */
+							(void*) elementAt(i),		/* Points to the scalar or array data */
 							variant->arrayDimensionsSize, /* The number of dimensions */
 							NULL						/* Pointer to dimensionsArray */
 						};
@@ -440,12 +301,12 @@ namespace Umati {
 					return;
 				}
 				UA_UInt32 offset = 1;
-				for(UA_UInt32 i = dimensionNumber + 1; i < variant->arrayDimensionsSize - 1; i++) {
+				for(UA_UInt32 i = dimensionNumber + 1; i < variant->arrayDimensionsSize; i++) {
 					offset = offset * variant->arrayDimensions[i];
 				}
 				for(UA_UInt32 i = 0; i < variant->arrayDimensions[dimensionNumber]; i++) {
 					auto nestedj = nlohmann::json::array();
-					getValueFromDataValueArray<T>(variant, dimensionNumber + 1, &nestedj, &variantData[i * offset], serializeStatusInformation);
+					getValueFromDataValueArray<T>(variant, dimensionNumber + 1, &nestedj, elementAt(i * offset), serializeStatusInformation);
 					j->push_back(nestedj);
 				}
 			}
@@ -464,6 +325,10 @@ namespace Umati {
 		break; }
 
 			void UaDataValueToJsonValue::setValueFromArrayVariant(UA_Variant &variant, nlohmann::json *jsonValue, bool serializeStatusInformation) {
+				// Bulk conversion of booleans and numbers, the cases below convert element by element
+				if (UaNumericArray::toJson(variant, *jsonValue)) {
+					return;
+				}
 				switch (variant.type->typeKind) {
 					SIMPLECASE(BOOLEAN, Boolean);
 					SIMPLECASE(SBYTE, SByte);
@@ -491,13 +356,17 @@ namespace Umati {
 					CASENOTIMPLEMENTED(VARIANT, Variant);
 					CASENOTIMPLEMENTED(DIAGNOSTICINFO, DiagnosticInfo);
 
-					case UA_DATATYPEKIND_STRUCTURE: {
-						if (strcmp(variant.type->typeName, "EUInformation") == 0) {
+					case UA_DATATYPEKIND_STRUCTURE:
+					case UA_DATATYPEKIND_OPTSTRUCT: {
+						if (variant.type == &UA_TYPES[UA_TYPES_EUINFORMATION]) {
 							VALUEFROMDATAARRAY(EUINFORMATION, EUInformation);
 							break;
-						} else if (strcmp(variant.type->typeName, "Range") == 0) {
+						} else if (variant.type == &UA_TYPES[UA_TYPES_RANGE]) {
 							VALUEFROMDATAARRAY(RANGE, Range);
 							break;
+						} else if (UaStructurePlans::current()->findByTypeId(variant.type->typeId)) {
+							getValueFromDataValueArray<void>(&variant, UA_UInt32(0), jsonValue, variant.data, serializeStatusInformation);
+							break;
 						} else {
 							LOG(ERROR) << "Unknown data type. ";
 							break;
@@ -538,6 +407,61 @@ namespace Umati {
 				}
 			}
 
+			void UaDataValueToJsonValue::setValueFromStructure(const UaStructurePlans::Plan_t &plan, const void *data,
+															   nlohmann::json *jsonValue, bool serializeStatusInformation) {
+				*jsonValue = nlohmann::json::object();
+				auto pStructure = static_cast<const char*>(data);
+				for (const auto &member : plan.Members) {
+					const char *pMember = pStructure + member.Offset;
+					if (member.IsArray) {
+						auto size = *reinterpret_cast<const size_t*>(pMember);
+						auto pElements = *reinterpret_cast<const char* const*>(pMember + sizeof(size_t));
+						if (member.IsOptional && !pElements) {
+							continue;
+						}
+						auto &jsonArray = (*jsonValue)[member.Name] = nlohmann::json::array();
+						if (UaNumericArray::isSupported(member.Type)) {
+							UA_Variant variant;
+							UA_Variant_setArray(&variant, const_cast<char*>(pElements), size, member.Type);
+							UaNumericArray::toJson(variant, jsonArray);
+							continue;
+						}
+						for (size_t i = 0; i < size; ++i) {
+							nlohmann::json element;
+							setValueFromMember(member, pElements + i * member.Type->memSize, &element, serializeStatusInformation);
+							jsonArray.push_back(std::move(element));
+						}
+						continue;
+					}
+					if (member.IsOptional) {
+						pMember = *reinterpret_cast<const char* const*>(pMember);
+						if (!pMember) {
+							continue;
+						}
+					}
+					setValueFromMember(member, pMember, &(*jsonValue)[member.Name], serializeStatusInformation);
+				}
+			}
+
+			void UaDataValueToJsonValue::setValueFromMember(const UaStructurePlans::Member_t &member, const void *data,
+															nlohmann::json *jsonValue, bool serializeStatusInformation) {
+				if (member.pPlan) {
+					setValueFromStructure(*member.pPlan, data, jsonValue, serializeStatusInformation);
+					return;
+				}
+				if (member.Type->typeKind == UA_DATATYPEKIND_VARIANT) {
+					UA_DataValue dataValue;
+					UA_DataValue_init(&dataValue);
+					dataValue.value = *static_cast<const UA_Variant*>(data);
+					dataValue.hasValue = true;
+					*jsonValue = UaDataValueToJsonValue(dataValue).getValue();
+					return;
+				}
+				UA_Variant variant;
+				UA_Variant_setScalar(&variant, const_cast<void*>(data), member.Type);
+				setValueFromScalarVariant(variant, jsonValue, serializeStatusInformation);
+			}
+
 			void UaDataValueToJsonValue::setStatusCodeFromDataValue(const UA_DataValue &dataValue) {
 				auto &jsonStatusCode = m_value["statusCode"];
 
@@ -11,6 +11,7 @@
 
 #include <nlohmann/json.hpp>
 #include <open62541/client.h>
+#include "UaStructurePlans.hpp"
 
 namespace Umati {
 	namespace OpcUa {
@@ -33,6 +34,13 @@ namespace Umati {
 
 				void setValueFromDataValue(const UA_DataValue &dataValue, bool serializeStatusInformation = false);
 
+				/// Converts a registered custom structure member by member, absent optional members are omitted
+				void setValueFromStructure(const UaStructurePlans::Plan_t &plan, const void *data, nlohmann::json *jsonValue,
+										   bool serializeStatusInformation);
+
+				void setValueFromMember(const UaStructurePlans::Member_t &member, const void *data, nlohmann::json *jsonValue,
+										bool serializeStatusInformation);
+
 				void setStatusCodeFromDataValue(const UA_DataValue &dataValue);
 
 				nlohmann::json m_value;
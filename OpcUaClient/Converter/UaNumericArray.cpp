@@ -0,0 +1,101 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "UaNumericArray.hpp"
+#include <utility>
+
+namespace Umati {
+	namespace OpcUa {
+		namespace Converter {
+			bool UaNumericArray::isSupported(const UA_DataType *type) {
+				if (!type) {
+					return false;
+				}
+				switch (type->typeKind) {
+					case UA_DATATYPEKIND_BOOLEAN:
+					case UA_DATATYPEKIND_SBYTE:
+					case UA_DATATYPEKIND_BYTE:
+					case UA_DATATYPEKIND_INT16:
+					case UA_DATATYPEKIND_UINT16:
+					case UA_DATATYPEKIND_INT32:
+					case UA_DATATYPEKIND_UINT32:
+					case UA_DATATYPEKIND_INT64:
+					case UA_DATATYPEKIND_UINT64:
+					case UA_DATATYPEKIND_FLOAT:
+					case UA_DATATYPEKIND_DOUBLE:
+						return true;
+					default:
+						return false;
+				}
+			}
+
+			bool UaNumericArray::toJson(const UA_Variant &variant, nlohmann::json &jsonValue) {
+				if (!isSupported(variant.type)) {
+					return false;
+				}
+				if (variant.arrayLength == 0) {
+					return true;
+				}
+
+				const UA_UInt32 arrayLength = static_cast<UA_UInt32>(variant.arrayLength);
+				const UA_UInt32 *dimensions = variant.arrayDimensions;
+				std::size_t dimensionsSize = variant.arrayDimensionsSize;
+				std::size_t numElements = dimensionsSize > 0 ? 1 : 0;
+				for (std::size_t i = 0; i < dimensionsSize && numElements != 0; ++i) {
+					// Stop before the product could overflow and wrap around to arrayLength
+					numElements = dimensions[i] <= variant.arrayLength / numElements ? numElements * dimensions[i] : 0;
+				}
+				// Never read beyond the data
+				if (numElements != variant.arrayLength) {
+					dimensions = &arrayLength;
+					dimensionsSize = 1;
+				}
+
+				switch (variant.type->typeKind) {
+					case UA_DATATYPEKIND_BOOLEAN: toJson<UA_Boolean>(variant, dimensions, dimensionsSize, jsonValue); break;
+					case UA_DATATYPEKIND_SBYTE: toJson<UA_SByte>(variant, dimensions, dimensionsSize, jsonValue); break;
+					case UA_DATATYPEKIND_BYTE: toJson<UA_Byte>(variant, dimensions, dimensionsSize, jsonValue); break;
+					case UA_DATATYPEKIND_INT16: toJson<UA_Int16>(variant, dimensions, dimensionsSize, jsonValue); break;
+					case UA_DATATYPEKIND_UINT16: toJson<UA_UInt16>(variant, dimensions, dimensionsSize, jsonValue); break;
+					case UA_DATATYPEKIND_INT32: toJson<UA_Int32>(variant, dimensions, dimensionsSize, jsonValue); break;
+					case UA_DATATYPEKIND_UINT32: toJson<UA_UInt32>(variant, dimensions, dimensionsSize, jsonValue); break;
+					case UA_DATATYPEKIND_INT64: toJson<UA_Int64>(variant, dimensions, dimensionsSize, jsonValue); break;
+					case UA_DATATYPEKIND_UINT64: toJson<UA_UInt64>(variant, dimensions, dimensionsSize, jsonValue); break;
+					case UA_DATATYPEKIND_FLOAT: toJson<UA_Float>(variant, dimensions, dimensionsSize, jsonValue); break;
+					case UA_DATATYPEKIND_DOUBLE: toJson<UA_Double>(variant, dimensions, dimensionsSize, jsonValue); break;
+				}
+				return true;
+			}
+
+			template<typename T>
+			void UaNumericArray::toJson(const UA_Variant &variant, const UA_UInt32 *dimensions, std::size_t dimensionsSize,
+										nlohmann::json &jsonValue) {
+				const T *data = static_cast<const T *>(variant.data);
+				appendDimension(data, dimensions, dimensionsSize, jsonValue);
+			}
+
+			template<typename T>
+			void UaNumericArray::appendDimension(const T *&data, const UA_UInt32 *dimensions, std::size_t dimensionsSize,
+												 nlohmann::json &jsonValue) {
+				// The array is built first and moved into the json value, so it is allocated once per dimension
+				nlohmann::json::array_t values;
+				values.reserve(dimensions[0]);
+				if (dimensionsSize == 1) {
+					// Row major order, the last dimension is contiguous
+					const T *end = data + dimensions[0];
+					for (; data != end; ++data) {
+						values.emplace_back(*data);
+					}
+				} else {
+					for (UA_UInt32 i = 0; i < dimensions[0]; ++i) {
+						values.emplace_back();
+						appendDimension(data, dimensions + 1, dimensionsSize - 1, values.back());
+					}
+				}
+				jsonValue = std::move(values);
+			}
+		}
+	}
+}
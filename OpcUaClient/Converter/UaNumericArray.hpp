@@ -0,0 +1,41 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <open62541/types.h>
+#include <cstddef>
+
+namespace Umati {
+	namespace OpcUa {
+		namespace Converter {
+			/**
+			* Converts arrays of booleans and numbers in one pass over the contiguous variant data,
+			* without a UA_Variant and a temporary json value per element. Used for large measurement arrays.
+			*/
+			class UaNumericArray {
+			public:
+				/// Boolean and the integer and floating point types
+				static bool isSupported(const UA_DataType *type);
+
+				/// Writes a (nested) json array, one level per entry of arrayDimensions.
+				/// Without matching arrayDimensions the array is treated as one-dimensional.
+				/// An empty array leaves jsonValue unchanged.
+				/// \return false if the element type is not supported
+				static bool toJson(const UA_Variant &variant, nlohmann::json &jsonValue);
+
+			protected:
+				template<typename T>
+				static void appendDimension(const T *&data, const UA_UInt32 *dimensions, std::size_t dimensionsSize,
+											nlohmann::json &jsonValue);
+
+				template<typename T>
+				static void toJson(const UA_Variant &variant, const UA_UInt32 *dimensions, std::size_t dimensionsSize,
+								   nlohmann::json &jsonValue);
+			};
+		}
+	}
+}
@@ -0,0 +1,152 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "UaStructurePlans.hpp"
+
+#include <easylogging++.h>
+#include <mutex>
+#include <set>
+#include <utility>
+
+namespace Umati {
+	namespace OpcUa {
+		namespace Converter {
+			namespace {
+				std::shared_ptr<const UaStructurePlans> &currentPlans() {
+					static std::shared_ptr<const UaStructurePlans> plans = std::make_shared<const UaStructurePlans>();
+					return plans;
+				}
+
+				struct UnknownEncodings_t {
+					std::mutex Mutex;
+					std::set<std::pair<UA_UInt16, UA_UInt32>> EncodingIds;
+				};
+
+				UnknownEncodings_t &unknownEncodings() {
+					static UnknownEncodings_t encodings;
+					return encodings;
+				}
+			}
+
+			void UaStructurePlans::update(const UA_DataTypeArray *pCustomTypes, std::shared_ptr<const void> owner) {
+				auto pPlans = std::make_shared<UaStructurePlans>();
+				pPlans->m_owner = std::move(owner);
+				std::unordered_map<const UA_DataType *, const Plan_t *> byType;
+
+				for (auto pArray = pCustomTypes; pArray; pArray = pArray->next) {
+					for (std::size_t i = 0; i < pArray->typesSize; ++i) {
+						const UA_DataType &type = pArray->types[i];
+						if (!isStructure(type)) {
+							continue;
+						}
+
+						pPlans->m_plans.emplace_back();
+						Plan_t &plan = pPlans->m_plans.back();
+						plan.Type = &type;
+						std::size_t offset = 0;
+						for (std::size_t m = 0; m < type.membersSize; ++m) {
+							const UA_DataTypeMember &typeMember = type.members[m];
+							Member_t member;
+							member.Name = typeMember.memberName;
+							member.Type = typeMember.memberType;
+							member.IsArray = typeMember.isArray;
+							member.IsOptional = typeMember.isOptional;
+							// Same layout rules as the (de)serialization of structures in open62541
+							offset += typeMember.padding;
+							member.Offset = offset;
+							if (member.IsArray) {
+								offset += sizeof(std::size_t) + sizeof(void *);
+							} else if (member.IsOptional) {
+								offset += sizeof(void *);
+							} else {
+								offset += member.Type->memSize;
+							}
+							plan.Members.push_back(std::move(member));
+						}
+
+						byType[&type] = &plan;
+						std::uint64_t typeKey;
+						if (key(type.typeId, typeKey)) {
+							pPlans->m_byTypeId[typeKey] = &plan;
+						}
+						if (key(type.binaryEncodingId, typeKey)) {
+							pPlans->m_byEncodingId[typeKey] = &plan;
+						}
+					}
+				}
+
+				// Nested structures, members may reference types of any of the arrays
+				for (auto &plan : pPlans->m_plans) {
+					for (auto &member : plan.Members) {
+						auto it = byType.find(member.Type);
+						if (it != byType.end()) {
+							member.pPlan = it->second;
+						}
+					}
+				}
+
+				LOG(INFO) << "Created conversion plans for " << pPlans->m_plans.size() << " custom structures";
+				std::atomic_store(&currentPlans(), std::shared_ptr<const UaStructurePlans>(std::move(pPlans)));
+			}
+
+			std::shared_ptr<const UaStructurePlans> UaStructurePlans::current() {
+				return std::atomic_load(&currentPlans());
+			}
+
+			void UaStructurePlans::reportUnknownEncoding(const UA_NodeId &encodingId) {
+				if (encodingId.identifierType != UA_NODEIDTYPE_NUMERIC) {
+					return;
+				}
+				auto &encodings = unknownEncodings();
+				std::lock_guard<std::mutex> l(encodings.Mutex);
+				encodings.EncodingIds.emplace(encodingId.namespaceIndex, encodingId.identifier.numeric);
+			}
+
+			std::vector<UA_NodeId> UaStructurePlans::takeUnknownEncodings() {
+				std::set<std::pair<UA_UInt16, UA_UInt32>> encodingIds;
+				{
+					auto &encodings = unknownEncodings();
+					std::lock_guard<std::mutex> l(encodings.Mutex);
+					std::swap(encodingIds, encodings.EncodingIds);
+				}
+				std::vector<UA_NodeId> result;
+				for (const auto &encodingId : encodingIds) {
+					result.push_back(UA_NODEID_NUMERIC(encodingId.first, encodingId.second));
+				}
+				return result;
+			}
+
+			const UaStructurePlans::Plan_t *UaStructurePlans::findByTypeId(const UA_NodeId &typeId) const {
+				std::uint64_t typeKey;
+				if (!key(typeId, typeKey)) {
+					return nullptr;
+				}
+				auto it = m_byTypeId.find(typeKey);
+				return it == m_byTypeId.end() ? nullptr : it->second;
+			}
+
+			const UaStructurePlans::Plan_t *UaStructurePlans::findByEncodingId(const UA_NodeId &encodingId) const {
+				std::uint64_t encodingKey;
+				if (!key(encodingId, encodingKey)) {
+					return nullptr;
+				}
+				auto it = m_byEncodingId.find(encodingKey);
+				return it == m_byEncodingId.end() ? nullptr : it->second;
+			}
+
+			bool UaStructurePlans::key(const UA_NodeId &nodeId, std::uint64_t &key) {
+				if (nodeId.identifierType != UA_NODEIDTYPE_NUMERIC) {
+					return false;
+				}
+				key = (static_cast<std::uint64_t>(nodeId.namespaceIndex) << 32) | nodeId.identifier.numeric;
+				return true;
+			}
+
+			bool UaStructurePlans::isStructure(const UA_DataType &type) {
+				return type.typeKind == UA_DATATYPEKIND_STRUCTURE || type.typeKind == UA_DATATYPEKIND_OPTSTRUCT;
+			}
+		}
+	}
+}
@@ -0,0 +1,81 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <open62541/types.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Umati {
+	namespace OpcUa {
+		namespace Converter {
+			/**
+			* Member layout of the registered custom structures (like UA_TYPES_MACHINERY_RESULT and UA_TYPES_TIGHTENING),
+			* computed once from the UA_DataType descriptions, so UaDataValueToJsonValue converts every structure
+			* without type specific code.
+			* The plans are immutable, update() replaces the current set.
+			*/
+			class UaStructurePlans {
+			public:
+				struct Plan_t;
+
+				struct Member_t {
+					std::string Name;
+					const UA_DataType *Type = nullptr;
+					/// Plan of Type if it is a registered structure
+					const Plan_t *pPlan = nullptr;
+					/// Offset in the structure, after the padding of the member.
+					/// Arrays store the length followed by the data pointer, optional scalars a pointer.
+					std::size_t Offset = 0;
+					bool IsArray = false;
+					bool IsOptional = false;
+				};
+
+				struct Plan_t {
+					const UA_DataType *Type = nullptr;
+					std::vector<Member_t> Members;
+				};
+
+				/// Creates the plans of all structures in pCustomTypes and the arrays linked by next.
+				/// Has to be called again after the namespace indices of the types changed or types were added.
+				/// owner is kept alive as long as the plans are used, e.g. the storage of types created at runtime.
+				static void update(const UA_DataTypeArray *pCustomTypes, std::shared_ptr<const void> owner = nullptr);
+
+				/// Called by the converter for encoded structures without plan, only numeric ids are recorded
+				static void reportUnknownEncoding(const UA_NodeId &encodingId);
+
+				/// Encodings reported since the last call, each is returned once
+				static std::vector<UA_NodeId> takeUnknownEncodings();
+
+				/// The plans of the last update, never nullptr
+				static std::shared_ptr<const UaStructurePlans> current();
+
+				/// \return nullptr if no registered structure has this typeId
+				const Plan_t *findByTypeId(const UA_NodeId &typeId) const;
+
+				/// \return nullptr if no registered structure has this binaryEncodingId
+				const Plan_t *findByEncodingId(const UA_NodeId &encodingId) const;
+
+			protected:
+				/// Namespace index and numeric identifier, false for other identifier types
+				static bool key(const UA_NodeId &nodeId, std::uint64_t &key);
+
+				static bool isStructure(const UA_DataType &type);
+
+				/// A deque keeps the addresses stable for Member_t::pPlan
+				std::deque<Plan_t> m_plans;
+				std::unordered_map<std::uint64_t, const Plan_t *> m_byTypeId;
+				std::unordered_map<std::uint64_t, const Plan_t *> m_byEncodingId;
+				std::shared_ptr<const void> m_owner;
+			};
+		}
+	}
+}
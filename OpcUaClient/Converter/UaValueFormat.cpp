@@ -0,0 +1,117 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "UaValueFormat.hpp"
+#include <cstdint>
+
+namespace Umati {
+	namespace OpcUa {
+		namespace Converter {
+			namespace {
+				const char HexDigits[] = "0123456789abcdef";
+
+				/// Writes value with exactly width digits, leading zeros are added
+				char *writeDigits(std::uint32_t value, int width, char *buffer) {
+					for (int i = width - 1; i >= 0; --i) {
+						buffer[i] = static_cast<char>('0' + value % 10);
+						value /= 10;
+					}
+					return buffer + width;
+				}
+
+				char *writeHex(std::uint32_t value, int width, char *buffer) {
+					for (int i = width - 1; i >= 0; --i) {
+						buffer[i] = HexDigits[value & 0xF];
+						value >>= 4;
+					}
+					return buffer + width;
+				}
+
+				/// Division rounding towards negative infinity, UA_DateTime is negative before 1970
+				std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) {
+					std::int64_t quotient = value / divisor;
+					if ((value % divisor) < 0) {
+						--quotient;
+					}
+					return quotient;
+				}
+			}
+
+			std::size_t UaValueFormat::writeDateTime(UA_DateTime dateTime, char *buffer) {
+				// Milliseconds first, dateTime - UA_DATETIME_UNIX_EPOCH overflows for the smallest values
+				const std::int64_t msSinceUnixEpoch =
+					floorDiv(dateTime, UA_DATETIME_MSEC) - UA_DATETIME_UNIX_EPOCH / UA_DATETIME_MSEC;
+				const std::int64_t msPerDay = 24 * 60 * 60 * 1000;
+				const std::int64_t days = floorDiv(msSinceUnixEpoch, msPerDay);
+				auto msOfDay = static_cast<std::uint32_t>(msSinceUnixEpoch - days * msPerDay);
+
+				// Civil date of a day count, see Howard Hinnant, "chrono-Compatible Low-Level Date Algorithms"
+				const std::int64_t z = days + 719468;
+				const std::int64_t era = floorDiv(z, 146097);
+				const auto dayOfEra = static_cast<std::uint32_t>(z - era * 146097);
+				const std::uint32_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+				const std::uint32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+				const std::uint32_t shiftedMonth = (5 * dayOfYear + 2) / 153;
+				const std::uint32_t day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+				const std::uint32_t month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+				const std::int64_t year = static_cast<std::int64_t>(yearOfEra) + era * 400 + (month <= 2 ? 1 : 0);
+
+				char *p = buffer;
+				// UA_DateTime spans the years -27627 to 30828, written as ISO 8601 expanded years with at least four digits
+				if (year < 0) {
+					*p++ = '-';
+				}
+				const auto absYear = static_cast<std::uint32_t>(year < 0 ? -year : year);
+				int yearWidth = 4;
+				for (std::uint32_t limit = 10000; absYear >= limit; limit *= 10) {
+					++yearWidth;
+				}
+				p = writeDigits(absYear, yearWidth, p);
+				*p++ = '-';
+				p = writeDigits(month, 2, p);
+				*p++ = '-';
+				p = writeDigits(day, 2, p);
+				*p++ = 'T';
+				p = writeDigits(msOfDay / 3600000, 2, p);
+				msOfDay %= 3600000;
+				*p++ = ':';
+				p = writeDigits(msOfDay / 60000, 2, p);
+				msOfDay %= 60000;
+				*p++ = ':';
+				p = writeDigits(msOfDay / 1000, 2, p);
+				*p++ = '.';
+				p = writeDigits(msOfDay % 1000, 3, p);
+				*p++ = 'Z';
+				return static_cast<std::size_t>(p - buffer);
+			}
+
+			std::string UaValueFormat::dateTimeToString(UA_DateTime dateTime) {
+				char buffer[MaxDateTimeLength];
+				return std::string(buffer, writeDateTime(dateTime, buffer));
+			}
+
+			void UaValueFormat::writeGuid(const UA_Guid &guid, char *buffer) {
+				char *p = writeHex(guid.data1, 8, buffer);
+				*p++ = '-';
+				p = writeHex(guid.data2, 4, p);
+				*p++ = '-';
+				p = writeHex(guid.data3, 4, p);
+				*p++ = '-';
+				for (std::size_t i = 0; i < 8; ++i) {
+					if (i == 2) {
+						*p++ = '-';
+					}
+					p = writeHex(guid.data4[i], 2, p);
+				}
+			}
+
+			std::string UaValueFormat::guidToString(const UA_Guid &guid) {
+				char buffer[GuidLength];
+				writeGuid(guid, buffer);
+				return std::string(buffer, GuidLength);
+			}
+		}
+	}
+}
@@ -0,0 +1,38 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <open62541/types.h>
+#include <cstddef>
+#include <string>
+
+namespace Umati {
+	namespace OpcUa {
+		namespace Converter {
+			/**
+			* String representations of OPC UA scalars, written into fixed size buffers without streams or locales.
+			*/
+			class UaValueFormat {
+			public:
+				/// Enough for every UA_DateTime, years before 0 have a sign and years beyond 9999 more than four digits
+				static constexpr std::size_t MaxDateTimeLength = 32;
+				static constexpr std::size_t GuidLength = 36;
+
+				/// Writes an RFC 3339 UTC timestamp with milliseconds, e.g. 2021-09-13T07:05:09.042Z.
+				/// Years outside 0000 to 9999 are written as ISO 8601 expanded years, e.g. -0001 or 30828.
+				/// \return number of characters written, no terminating null character is written
+				static std::size_t writeDateTime(UA_DateTime dateTime, char *buffer);
+
+				static std::string dateTimeToString(UA_DateTime dateTime);
+
+				/// Writes the canonical lower case form, e.g. 72962b91-fa75-4ae6-8d28-b404dc7daf63
+				static void writeGuid(const UA_Guid &guid, char *buffer);
+
+				static std::string guidToString(const UA_Guid &guid);
+			};
+		}
+	}
+}
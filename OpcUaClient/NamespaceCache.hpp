@@ -0,0 +1,64 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+
+namespace Umati
+{
+	namespace OpcUa
+	{
+		/**
+		 * Mapping between namespace URIs and the server's namespace indices.
+		 * Read by every service call and subscription callback, replaced as a whole after the namespace array changed.
+		 */
+		class NamespaceCache
+		{
+		public:
+			/// Const reference to one of the maps, holds a shared lock while it exists.
+			/// Use it as a temporary within one expression and never take two of them in the same expression,
+			/// a waiting replace() would block the second one.
+			template<typename Map>
+			class LockedMap
+			{
+			public:
+				LockedMap(std::shared_timed_mutex &mutex, const Map &map) : m_lock(mutex), m_map(map) {}
+
+				operator const Map &() const { return m_map; }
+
+				const Map &get() const { return m_map; }
+
+			private:
+				std::shared_lock<std::shared_timed_mutex> m_lock;
+				const Map &m_map;
+			};
+
+			typedef std::map<std::string, uint16_t> UriToIndex_t;
+			typedef std::map<uint16_t, std::string> IndexToUri_t;
+
+			LockedMap<UriToIndex_t> uriToIndex() const { return LockedMap<UriToIndex_t>(m_mutex, m_uriToIndex); }
+
+			LockedMap<IndexToUri_t> indexToUri() const { return LockedMap<IndexToUri_t>(m_mutex, m_indexToUri); }
+
+			void replace(UriToIndex_t uriToIndex, IndexToUri_t indexToUri)
+			{
+				std::unique_lock<std::shared_timed_mutex> l(m_mutex);
+				m_uriToIndex = std::move(uriToIndex);
+				m_indexToUri = std::move(indexToUri);
+			}
+
+		private:
+			mutable std::shared_timed_mutex m_mutex;
+			UriToIndex_t m_uriToIndex;
+			IndexToUri_t m_indexToUri;
+		};
+	}
+}
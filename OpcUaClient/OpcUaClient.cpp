@@ -20,8 +20,11 @@
 #include "Converter/UaQualifiedNameToModelQualifiedName.hpp"
 #include "Converter/UaNodeClassToModelNodeClass.hpp"
 #include "Converter/UaDataValueToJsonValue.hpp"
+#include "Converter/UaStructurePlans.hpp"
 #include "Converter/CustomDataTypes/types_machinery_result_generated_handling.h"
 #include "Converter/CustomDataTypes/types_tightening_generated_handling.h"
+#include <algorithm>
+#include <iterator>
 
 
 namespace Umati
@@ -29,7 +32,9 @@ namespace Umati
 
 	namespace OpcUa
 	{
-
+		/// Delays between attempts to load a data type after communication errors
+		static const std::chrono::seconds FirstEncodingRetryDelay(5);
+		static const std::chrono::seconds MaxEncodingRetryDelay(300);
 
 		static void stateCallback(UA_Client *client,
                           UA_SecureChannelState channelState,
@@ -83,16 +88,23 @@ namespace Umati
 		OpcUaClient::OpcUaClient(std::string serverURI, std::function<void()> issueReset,
 								 std::string Username, std::string Password,
 								 std::uint8_t security, std::vector<std::string> expectedObjectTypeNamespaces,
-								 std::shared_ptr<Umati::OpcUa::OpcUaInterface> opcUaWrapper, bool bypassCertVerification)
-			: m_issueReset(issueReset),
+								 std::shared_ptr<Umati::OpcUa::OpcUaInterface> opcUaWrapper, bool bypassCertVerification,
+								 std::uint32_t browsePageSize, std::uint32_t maxMonitoredItemsPerCall,
+								 std::shared_ptr<SuperTypeCache> superTypeCache)
+			: m_maxMonitoredItemsPerCall(maxMonitoredItemsPerCall),
+			m_configuredMaxMonitoredItemsPerCall(maxMonitoredItemsPerCall),
+			m_issueReset(issueReset),
 			m_serverUri(std::move(serverURI)), m_username(std::move(Username)), m_password(std::move(Password)),
 			m_security(static_cast<UA_MessageSecurityMode>(security)),
-			m_subscr(m_uriToIndexCache, m_indexToUriCache),
+			m_browsePageSize(browsePageSize),
+			m_subscr(m_namespaceCache),
+			m_pSuperTypes(superTypeCache ? std::move(superTypeCache) : std::make_shared<SuperTypeCache>()),
+			m_pRuntimeDataTypes(std::make_shared<RuntimeDataTypes>()),
 			m_pClient(UA_Client_new(), UA_Client_delete),
 			m_dataTypeArray(getMachineryResultTypes())
         {
 			{
-				std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+				std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
 				UA_ClientConfig *config = UA_Client_getConfig(m_pClient.get());
 				if (bypassCertVerification) {
 					config->certificateVerification.verifyCertificate = &bypassVerify;
@@ -106,6 +118,7 @@ namespace Umati
 				config->stateCallback = stateCallback;
 				config->customDataTypes = &m_dataTypeArray;
 			}
+			Converter::UaStructurePlans::update(&m_dataTypeArray, m_pRuntimeDataTypes);
 
 			m_opcUaWrapper = std::move(opcUaWrapper);
 			m_opcUaWrapper->setSubscription(&m_subscr);
@@ -121,7 +134,7 @@ namespace Umati
 			UA_StatusCode  result;
 
 			{
-				std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+				std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
 				if(m_username.empty() && m_password.empty()){
 					result = m_opcUaWrapper->SessionConnect(m_pClient.get(), sURL);
 				}else{
@@ -155,10 +168,56 @@ namespace Umati
 		void OpcUaClient::on_connected()
 		{
 			updateNamespaceCache();
-			std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+			// The server might describe the data types differently now, pending retries start over
+			m_unsupportedEncodings.clear();
+			for (auto &retry : m_encodingRetries)
+			{
+				retry.second = EncodingRetry_t();
+			}
+			m_maxNodesPerBrowse = readOperationLimit(UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERBROWSE, DefaultMaxNodesPerBrowse);
+			m_maxNodesPerRead = readOperationLimit(UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERREAD, DefaultMaxNodesPerRead);
+			m_maxNodesPerTranslateBrowsePaths = readOperationLimit(
+				UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERTRANSLATEBROWSEPATHSTONODEIDS, DefaultMaxNodesPerBrowse);
+			// 0 = unlimited, for the configuration as well as for the server
+			auto serverMaxMonitoredItemsPerCall = readOperationLimit(
+				UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXMONITOREDITEMSPERCALL, 0);
+			m_maxMonitoredItemsPerCall = (m_configuredMaxMonitoredItemsPerCall == 0 || serverMaxMonitoredItemsPerCall == 0)
+				? std::max(m_configuredMaxMonitoredItemsPerCall, serverMaxMonitoredItemsPerCall)
+				: std::min(m_configuredMaxMonitoredItemsPerCall, serverMaxMonitoredItemsPerCall);
+			std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
 			m_opcUaWrapper->SubscriptionCreateSubscription(m_pClient.get());
 		}
 
+		std::size_t OpcUaClient::readOperationLimit(UA_UInt32 operationLimitNodeId, std::size_t defaultLimit)
+		{
+			UA_Variant value;
+			UA_Variant_init(&value);
+			UA_StatusCode uaResult;
+			{
+				std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
+				uaResult = UA_Client_readValueAttribute(m_pClient.get(), UA_NODEID_NUMERIC(0, operationLimitNodeId), &value);
+			}
+
+			std::size_t limit = defaultLimit;
+			if (UA_StatusCode_isBad(uaResult))
+			{
+				LOG(INFO) << "Reading operation limit i=" << operationLimitNodeId << " failed with "
+						  << UA_StatusCode_name(uaResult) << ", using " << defaultLimit;
+			}
+			else if (UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_UINT32]))
+			{
+				auto serverLimit = *static_cast<UA_UInt32 *>(value.data);
+				// 0 means that the server does not restrict this operation
+				if (serverLimit != 0)
+				{
+					limit = serverLimit;
+				}
+				LOG(INFO) << "Operation limit i=" << operationLimitNodeId << ": " << serverLimit << ", using " << limit;
+			}
+			UA_Variant_clear(&value);
+			return limit;
+		}
+
 		std::string OpcUaClient::getTypeName(const ModelOpcUa::NodeId_t &nodeId)
 		{
 			return readNodeBrowseName(nodeId);
@@ -167,13 +226,13 @@ namespace Umati
 		std::string OpcUaClient::readNodeBrowseName(const ModelOpcUa::NodeId_t &_nodeId)
 		{
 
-			auto nodeId = Converter::ModelNodeIdToUaNodeId(_nodeId, m_uriToIndexCache).getNodeId();
+			auto nodeId = Converter::ModelNodeIdToUaNodeId(_nodeId, m_namespaceCache.uriToIndex()).getNodeId();
 			checkConnection();
 
 			UA_QualifiedName resultname;
 			UA_QualifiedName_init(&resultname);
 			{
-				std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+				std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
 				auto uaResult = UA_Client_readBrowseNameAttribute(m_pClient.get(), *nodeId.NodeId, &resultname);
 
 				if (UA_StatusCode_isBad(uaResult))
@@ -198,7 +257,7 @@ namespace Umati
 			UA_NodeClass returnClass;
 			UA_NodeClass_init(&returnClass);
 			try{
-			std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+			std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
 			auto uaResult = UA_Client_readNodeClassAttribute(m_pClient.get(), *nodeId.NodeId, &returnClass);
 			if (UA_StatusCode_isBad(uaResult))
 			{
@@ -213,7 +272,7 @@ namespace Umati
 
 		void OpcUaClient::checkConnection()
 		{
-			std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+			std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
 			if (!this->m_isConnected || !m_opcUaWrapper->SessionIsConnected(m_pClient.get()))
 			{
 				connectionStatusChanged(0,UA_SERVERSTATE_FAILED);
@@ -255,7 +314,7 @@ namespace Umati
 			std::vector<UA_ReferenceDescription> referenceDescriptions;
 			UA_BrowseResponse uaResult;
 			{
-				std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+				std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
 
 				uaResult = m_opcUaWrapper->SessionBrowse(m_pClient.get(), /*m_defaultServiceSettings,*/ typeNodeId, browseContext,
 														  continuationPoint, referenceDescriptions);
@@ -301,24 +360,56 @@ namespace Umati
 				return true;
 			}
 
-			auto it = m_superTypes.find(checkType);
-
-			if (it != m_superTypes.end())
+			// Cached by namespace URI, the indices might differ after a reconnect
+			auto checkTypeModel = Converter::UaNodeIdToModelNodeId(checkType, m_namespaceCache.indexToUri()).getNodeId();
+			ModelOpcUa::NodeId_t superTypeModel;
+			if (m_pSuperTypes->get(checkTypeModel, superTypeModel))
 			{
-				return isSameOrSubtype(expectedType, it->second, --maxDepth);
+				if (superTypeModel.isNull())
+				{
+					return false;
+				}
+				auto superType = Converter::ModelNodeIdToUaNodeId(superTypeModel, m_namespaceCache.uriToIndex()).getNodeId();
+				return isSameOrSubtype(expectedType, superType, --maxDepth);
 			}
 
 			auto superType = browseSuperType(checkType);
-			m_superTypes[checkType] = superType;
+			if (!UA_NodeId_isNull(superType.NodeId))
+			{
+				superTypeModel = Converter::UaNodeIdToModelNodeId(superType, m_namespaceCache.indexToUri()).getNodeId();
+			}
+			m_pSuperTypes->put(checkTypeModel, superTypeModel);
 			return isSameOrSubtype(expectedType, superType, --maxDepth);
 		}
 
+		void OpcUaClient::prefetchSubtypes(const std::vector<ModelOpcUa::NodeId_t> &rootTypes)
+		{
+			std::size_t numPrefetched = 0;
+			std::vector<ModelOpcUa::NodeId_t> level(rootTypes);
+			while (!level.empty() && numPrefetched < m_pSuperTypes->capacity())
+			{
+				auto levelSubtypes = BrowseMany(level, BrowseContext_t::HasSubtype());
+				std::vector<ModelOpcUa::NodeId_t> nextLevel;
+				for (std::size_t i = 0; i < level.size(); ++i)
+				{
+					for (const auto &subtype : levelSubtypes[i])
+					{
+						m_pSuperTypes->put(subtype.NodeId, level[i]);
+						nextLevel.push_back(subtype.NodeId);
+						++numPrefetched;
+					}
+				}
+				level.swap(nextLevel);
+			}
+			LOG(INFO) << "Prefetched the supertypes of " << numPrefetched << " types";
+		}
+
         bool OpcUaClient::isSameOrSubtype(
                 const ModelOpcUa::NodeId_t &expectedType,
                 const ModelOpcUa::NodeId_t &checkType,
                 std::size_t maxDepth) {
-            auto expectedTypeUa = Converter::ModelNodeIdToUaNodeId(expectedType, m_uriToIndexCache).getNodeId();
-            auto checkTypeUa = Converter::ModelNodeIdToUaNodeId(checkType, m_uriToIndexCache).getNodeId();
+            auto expectedTypeUa = Converter::ModelNodeIdToUaNodeId(expectedType, m_namespaceCache.uriToIndex()).getNodeId();
+            auto checkTypeUa = Converter::ModelNodeIdToUaNodeId(checkType, m_namespaceCache.uriToIndex()).getNodeId();
             bool ret;
             try {
                 ret = isSameOrSubtype(expectedTypeUa, checkTypeUa, maxDepth);
@@ -330,16 +421,13 @@ namespace Umati
 
 		void OpcUaClient::initializeNamespaceCache()
 		{
-            std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+            std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
 			m_opcUaWrapper->SessionUpdateNamespaceTable(m_pClient.get());
-
-			m_uriToIndexCache.clear();
-			m_indexToUriCache.clear();
 		}
 
 		void OpcUaClient::updateNamespaceCache()
 		{
-			auto existingIndexToUri = m_indexToUriCache;
+			auto existingIndexToUri = m_namespaceCache.indexToUri().get();
 			initializeNamespaceCache();
 
 			auto uaNamespaces = m_opcUaWrapper->SessionGetNamespaceTable();
@@ -351,9 +439,10 @@ namespace Umati
 		}
 
 		bool OpcUaClient::verifyCompatibleNamespaceCache(std::map<uint16_t, std::string> oldIndexToUriCache) {
+			auto indexToUriCache = m_namespaceCache.indexToUri();
 			for(const auto &pair : oldIndexToUriCache){
-				auto newEntry = m_indexToUriCache.find(pair.first);
-				if(newEntry == m_indexToUriCache.end()) {
+				auto newEntry = indexToUriCache.get().find(pair.first);
+				if(newEntry == indexToUriCache.get().end()) {
 					LOG(INFO) << "Incompatible Namespace change detected. "
 								<<"Namespaces index no longer available: " << pair.first;
 					return false;
@@ -369,22 +458,30 @@ namespace Umati
 
 		void OpcUaClient::fillNamespaceCache(const std::vector<std::string> &uaNamespaces)
 		{
+			NamespaceCache::UriToIndex_t uriToIndex;
+			NamespaceCache::IndexToUri_t indexToUri;
 			for(size_t i = 0; i < uaNamespaces.size(); ++i){
 
 				std::string namespaceURI = uaNamespaces.at(i);
 
-				if ( m_uriToIndexCache.find(namespaceURI) == m_uriToIndexCache.end() ) {
-				    m_uriToIndexCache[namespaceURI] = static_cast<uint16_t>(i);
-					m_indexToUriCache[static_cast<uint16_t>(i)] = namespaceURI;
-
-					updateCustomDataTypesNamespace(namespaceURI, i);
+				if ( uriToIndex.find(namespaceURI) == uriToIndex.end() ) {
+				    uriToIndex[namespaceURI] = static_cast<uint16_t>(i);
+					indexToUri[static_cast<uint16_t>(i)] = namespaceURI;
 				} else {
                     LOG(INFO) << "Namespace already in cache";
 				}
 
 				LOG(INFO) << "index: " << std::to_string(i) << ", namespaceURI: " << namespaceURI;
 			}
+			// Readers on other threads see either the old or the new namespaces, never a partially filled cache
+			m_namespaceCache.replace(uriToIndex, indexToUri);
+
+			for (const auto &ns : uriToIndex) {
+				updateCustomDataTypesNamespace(ns.first, ns.second);
+			}
 
+			// The ids of the custom data types might have new namespace indices
+			Converter::UaStructurePlans::update(&m_dataTypeArray, m_pRuntimeDataTypes);
 		}
 
 		void OpcUaClient::updateCustomDataTypesNamespace(std::string namespaceURI, std::size_t namespaceIndex)
@@ -421,7 +518,7 @@ namespace Umati
 			ModelOpcUa::ModellingRule_t modellingRule = ModelOpcUa::ModellingRule_t::Optional;
 			UA_BrowseResponse uaResult2;
 			{
-            std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+            std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
 			uaResult2 = m_opcUaWrapper->SessionBrowse(m_pClient.get(), /*m_defaultServiceSettings,*/ uaNodeId,
 														   browseContext2,
 														   continuationPoint, referenceDescriptions);
@@ -498,14 +595,14 @@ namespace Umati
 			{
 				m_connectThread->join();
 			}
-			std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+			std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
 			m_subscr.deleteSubscription(m_pClient.get());
 			disconnect();
 		}
 
 		bool OpcUaClient::disconnect()
 		{
-			std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+			std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
 			m_subscr.deleteSubscription(m_pClient.get());
 			return (m_opcUaWrapper->SessionDisconnect(m_pClient.get(), UA_TRUE) != UA_STATUSCODE_GOOD) ? false : true;
 
@@ -521,10 +618,240 @@ namespace Umati
 				}
 				else
 				{
+					if (m_namespaceCacheOutdated.exchange(false))
+					{
+						LOG(INFO) << "Updating NamespaceCache because of " << UA_StatusCode_name(UA_STATUSCODE_BADNODEIDUNKNOWN);
+						updateNamespaceCache();
+					}
+					loadUnknownDataTypes();
 					std::this_thread::sleep_for(std::chrono::seconds(1));
 				}
 			}
 		}
+
+		void OpcUaClient::loadUnknownDataTypes()
+		{
+			// Reported encodings and those whose next attempt is due
+			std::set<EncodingId_t> encodings;
+			for (const auto &encodingId : Converter::UaStructurePlans::takeUnknownEncodings())
+			{
+				encodings.emplace(encodingId.namespaceIndex, encodingId.identifier.numeric);
+			}
+			const auto now = std::chrono::steady_clock::now();
+			for (const auto &retry : m_encodingRetries)
+			{
+				if (retry.second.NextAttempt <= now)
+				{
+					encodings.insert(retry.first);
+				}
+			}
+
+			std::size_t numAdded = 0;
+			for (const auto &encoding : encodings)
+			{
+				if (m_loadedEncodings.count(encoding) != 0 || m_unsupportedEncodings.count(encoding) != 0)
+				{
+					continue;
+				}
+				auto retryIt = m_encodingRetries.find(encoding);
+				if (retryIt != m_encodingRetries.end() && retryIt->second.NextAttempt > now)
+				{
+					continue;
+				}
+				try
+				{
+					const UA_NodeId encodingId = UA_NODEID_NUMERIC(encoding.first, encoding.second);
+					UA_NodeId dataTypeId;
+					UA_NodeId_init(&dataTypeId);
+					ScopeExitGuard dataTypeGuard([&]() { UA_NodeId_clear(&dataTypeId); });
+					if (browseDataTypeOfEncoding(encodingId, dataTypeId) && loadDataType(dataTypeId, 0))
+					{
+						m_loadedEncodings.insert(encoding);
+						++numAdded;
+					}
+					else
+					{
+						LOG(INFO) << "Values with encoding " << encoding.first << ":" << encoding.second
+								  << " are not decoded until the next connect";
+						m_unsupportedEncodings.insert(encoding);
+					}
+					if (retryIt != m_encodingRetries.end())
+					{
+						m_encodingRetries.erase(retryIt);
+					}
+				}
+				catch (const Exceptions::OpcUaException &ex)
+				{
+					auto &retry = m_encodingRetries[encoding];
+					retry.Delay = retry.Delay.count() == 0 ? FirstEncodingRetryDelay : std::min(retry.Delay * 2, MaxEncodingRetryDelay);
+					retry.NextAttempt = now + retry.Delay;
+					LOG(WARNING) << "Loading the data type of encoding " << encoding.first << ":" << encoding.second
+								 << " failed: " << ex.what() << ", trying again in " << retry.Delay.count() << "s";
+				}
+			}
+
+			if (numAdded > 0)
+			{
+				Converter::UaStructurePlans::update(&m_dataTypeArray, m_pRuntimeDataTypes);
+			}
+		}
+
+		bool OpcUaClient::browseDataTypeOfEncoding(const UA_NodeId &encodingId, UA_NodeId &dataTypeId)
+		{
+			UA_BrowseRequest browseRequest;
+			UA_BrowseRequest_init(&browseRequest);
+			UA_BrowseResponse browseResponse;
+			UA_BrowseResponse_init(&browseResponse);
+			ScopeExitGuard browseGuard([&]() {
+				UA_BrowseRequest_clear(&browseRequest);
+				UA_BrowseResponse_clear(&browseResponse);
+			});
+
+			browseRequest.nodesToBrowse = UA_BrowseDescription_new();
+			browseRequest.nodesToBrowseSize = 1;
+			UA_NodeId_copy(&encodingId, &browseRequest.nodesToBrowse->nodeId);
+			browseRequest.nodesToBrowse->browseDirection = UA_BROWSEDIRECTION_INVERSE;
+			browseRequest.nodesToBrowse->referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HASENCODING);
+			browseRequest.nodesToBrowse->includeSubtypes = UA_FALSE;
+			browseRequest.nodesToBrowse->nodeClassMask = UA_NODECLASS_DATATYPE;
+			browseRequest.nodesToBrowse->resultMask = UA_BROWSERESULTMASK_NONE;
+
+			{
+				std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
+				browseResponse = m_opcUaWrapper->SessionBrowse(m_pClient.get(), browseRequest);
+			}
+
+			if (UA_StatusCode_isBad(browseResponse.responseHeader.serviceResult))
+			{
+				throw Exceptions::OpcUaNonGoodStatusCodeException(browseResponse.responseHeader.serviceResult);
+			}
+			if (browseResponse.resultsSize != 1)
+			{
+				throw Exceptions::OpcUaException("BrowseResult length mismatch.");
+			}
+			if (UA_StatusCode_isBad(browseResponse.results->statusCode) || browseResponse.results->referencesSize == 0)
+			{
+				LOG(WARNING) << "No data type found for encoding " << encodingId.namespaceIndex << ":"
+							 << encodingId.identifier.numeric;
+				return false;
+			}
+
+			UA_NodeId_copy(&browseResponse.results->references->nodeId.nodeId, &dataTypeId);
+			return true;
+		}
+
+		const UA_DataType *OpcUaClient::loadDataType(const UA_NodeId &dataTypeId, std::size_t depth)
+		{
+			if (const UA_DataType *pType = m_pRuntimeDataTypes->find(dataTypeId))
+			{
+				return pType;
+			}
+			if (depth > MaxDataTypeDepth)
+			{
+				LOG(WARNING) << "Data types nested too deep, skipping further definitions";
+				return nullptr;
+			}
+
+			// Browse name (for the typeName) and definition with a single Read
+			const std::size_t readValueSize = 2;
+			UA_ReadValueId *readValueId = (UA_ReadValueId *) UA_Array_new(readValueSize, &UA_TYPES[UA_TYPES_READVALUEID]);
+			readValueId[0].attributeId = UA_ATTRIBUTEID_BROWSENAME;
+			readValueId[1].attributeId = UA_ATTRIBUTEID_DATATYPEDEFINITION;
+			UA_NodeId_copy(&dataTypeId, &readValueId[0].nodeId);
+			UA_NodeId_copy(&dataTypeId, &readValueId[1].nodeId);
+
+			UA_DiagnosticInfo info;
+			UA_DiagnosticInfo_init(&info);
+			UA_ReadResponse ret;
+			{
+				std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
+				ret = m_opcUaWrapper->SessionRead(m_pClient.get(), 0.0, UA_TIMESTAMPSTORETURN_NEITHER, readValueId, readValueSize, info);
+			}
+			ScopeExitGuard readGuard([&]() {
+				UA_Array_delete(readValueId, readValueSize, &UA_TYPES[UA_TYPES_READVALUEID]);
+				UA_ReadResponse_clear(&ret);
+			});
+
+			if (UA_StatusCode_isBad(ret.responseHeader.serviceResult))
+			{
+				throw Exceptions::OpcUaNonGoodStatusCodeException(ret.responseHeader.serviceResult);
+			}
+			if (ret.resultsSize != readValueSize)
+			{
+				throw Exceptions::OpcUaException("ReadResult length mismatch.");
+			}
+
+			std::string name = "DataType";
+			if (UA_Variant_hasScalarType(&ret.results[0].value, &UA_TYPES[UA_TYPES_QUALIFIEDNAME]))
+			{
+				auto pBrowseName = static_cast<const UA_QualifiedName *>(ret.results[0].value.data);
+				name.assign(reinterpret_cast<const char *>(pBrowseName->name.data), pBrowseName->name.length);
+			}
+
+			const UA_Variant &definition = ret.results[1].value;
+			if (UA_Variant_hasScalarType(&definition, &UA_TYPES[UA_TYPES_ENUMDEFINITION]))
+			{
+				// Enumerations are encoded as Int32
+				return &UA_TYPES[UA_TYPES_INT32];
+			}
+			if (!UA_Variant_hasScalarType(&definition, &UA_TYPES[UA_TYPES_STRUCTUREDEFINITION]))
+			{
+				LOG(WARNING) << "No structure definition for data type " << name << " ("
+							 << UA_StatusCode_name(ret.results[1].status) << ")";
+				return nullptr;
+			}
+
+			// Resolve the field types first, loading a field type adds it to m_pRuntimeDataTypes
+			auto pDefinition = static_cast<const UA_StructureDefinition *>(definition.data);
+			std::vector<const UA_DataType *> fieldTypes;
+			for (std::size_t i = 0; i < pDefinition->fieldsSize; ++i)
+			{
+				const UA_NodeId &fieldTypeId = pDefinition->fields[i].dataType;
+				const UA_DataType *pFieldType = nullptr;
+				if (fieldTypeId.namespaceIndex == 0)
+				{
+					pFieldType = findNs0FieldType(fieldTypeId);
+				}
+				else
+				{
+					pFieldType = UA_findDataTypeWithCustom(&fieldTypeId, &m_dataTypeArray);
+					if (!pFieldType)
+					{
+						pFieldType = loadDataType(fieldTypeId, depth + 1);
+					}
+				}
+				fieldTypes.push_back(pFieldType);
+			}
+
+			std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
+			return m_pRuntimeDataTypes->add(dataTypeId, name, *pDefinition, fieldTypes, m_dataTypeArray);
+		}
+
+		const UA_DataType *OpcUaClient::findNs0FieldType(const UA_NodeId &dataTypeId)
+		{
+			if (const UA_DataType *pType = UA_findDataType(&dataTypeId))
+			{
+				return pType;
+			}
+			if (dataTypeId.identifierType != UA_NODEIDTYPE_NUMERIC)
+			{
+				return nullptr;
+			}
+			switch (dataTypeId.identifier.numeric)
+			{
+			case UA_NS0ID_BASEDATATYPE:
+			case UA_NS0ID_NUMBER:
+			case UA_NS0ID_INTEGER:
+			case UA_NS0ID_UINTEGER:
+				return &UA_TYPES[UA_TYPES_VARIANT];
+			case UA_NS0ID_STRUCTURE:
+				return &UA_TYPES[UA_TYPES_EXTENSIONOBJECT];
+			case UA_NS0ID_ENUMERATION:
+				return &UA_TYPES[UA_TYPES_INT32];
+			default:
+				return nullptr;
+			}
+		}
 		std::list<ModelOpcUa::BrowseResult_t> OpcUaClient::Browse(
 			ModelOpcUa::NodeId_t startNode,
 			BrowseContext_t browseContext)
@@ -541,7 +868,7 @@ namespace Umati
 			UA_BrowseDescription uaBrowseContext = getUaBrowseContext(browseContext);
 			open62541Cpp::UA_NodeId typeDefinitionUaNodeId = Converter::ModelNodeIdToUaNodeId(
 											  typeDefinition,
-											  m_uriToIndexCache)
+											  m_namespaceCache.uriToIndex())
 											  .getNodeId();
 
 			uaBrowseContext.nodeClassMask = nodeClassFromNodeId(typeDefinitionUaNodeId);
@@ -581,27 +908,40 @@ namespace Umati
 			UA_BrowseDescription &browseContext,
 			std::function<bool(const UA_ReferenceDescription &)> filter)
 		{
-			Converter::ModelNodeIdToUaNodeId conv = Converter::ModelNodeIdToUaNodeId(startNode, m_uriToIndexCache);
+			Converter::ModelNodeIdToUaNodeId conv = Converter::ModelNodeIdToUaNodeId(startNode, m_namespaceCache.uriToIndex());
 			open62541Cpp::UA_NodeId startUaNodeId = conv.getNodeId();
 
-			UA_ByteString continuationPoint;
-			UA_ByteString_init(&continuationPoint);
-			std::vector<UA_ReferenceDescription> referenceDescriptions;
+			UA_BrowseRequest browseRequest;
+			UA_BrowseRequest_init(&browseRequest);
 			UA_BrowseResponse uaResult;
-
-			checkConnection();
-			{
-			std::lock_guard<std::recursive_mutex> l(m_clientMutex);
-			uaResult = m_opcUaWrapper->SessionBrowse(m_pClient.get(), /*m_defaultServiceSettings,*/ startUaNodeId, browseContext,
-														  continuationPoint, referenceDescriptions);
-			}
+			UA_BrowseResponse_init(&uaResult);
 
 			ScopeExitGuard browseGuard([&]() {
 			UA_BrowseDescription_clear(&browseContext);
+			UA_BrowseRequest_clear(&browseRequest);
 			UA_BrowseResponse_clear(&uaResult);
-			UA_ByteString_clear(&continuationPoint);
 			});
 
+			browseRequest.requestedMaxReferencesPerNode = m_browsePageSize;
+			browseRequest.nodesToBrowse = UA_BrowseDescription_new();
+			browseRequest.nodesToBrowseSize = 1;
+			UA_BrowseDescription_copy(&browseContext, browseRequest.nodesToBrowse);
+			UA_NodeId_copy(startUaNodeId.NodeId, &browseRequest.nodesToBrowse->nodeId);
+
+			checkConnection();
+			{
+			std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
+			uaResult = m_opcUaWrapper->SessionBrowse(m_pClient.get(), browseRequest);
+			}
+
+			if (UA_StatusCode_isBad(uaResult.responseHeader.serviceResult))
+			{
+				LOG(ERROR) << "Bad return from browse with startUaNodeId: "
+						   << startUaNodeId.NodeId->identifier.string.data
+						   << " (" << UA_StatusCode_name(uaResult.responseHeader.serviceResult) << ")";
+				throw Exceptions::OpcUaNonGoodStatusCodeException(uaResult.responseHeader.serviceResult);
+			}
+
 			if (uaResult.resultsSize > 0 && UA_StatusCode_isBad(uaResult.results->statusCode))
 			{
 				LOG(ERROR) << "Bad return from browse with startUaNodeId: "
@@ -613,33 +953,190 @@ namespace Umati
 			}
 
 			std::list<ModelOpcUa::BrowseResult_t> browseResult;
-			ReferenceDescriptionsToBrowseResults(referenceDescriptions, browseResult, filter);
-
-			handleContinuationPoint(continuationPoint);
+			if (uaResult.resultsSize > 0)
+			{
+				appendBrowseResultPages(*uaResult.results, browseResult, filter);
+			}
 
 			return browseResult;
 		}
 
+		std::vector<std::list<ModelOpcUa::BrowseResult_t>> OpcUaClient::BrowseMany(
+			const std::vector<ModelOpcUa::NodeId_t> &startNodes,
+			BrowseContext_t browseContext)
+		{
+			std::vector<std::list<ModelOpcUa::BrowseResult_t>> browseResults(startNodes.size());
+			if (startNodes.empty())
+			{
+				return browseResults;
+			}
+
+			checkConnection();
+			UA_BrowseDescription uaBrowseContext = getUaBrowseContext(browseContext);
+			ScopeExitGuard contextGuard([&]() {
+				UA_BrowseDescription_clear(&uaBrowseContext);
+			});
+
+			const std::size_t maxNodesPerBrowse = m_maxNodesPerBrowse;
+			bool unknownNodeIdFound = false;
+			for (std::size_t offset = 0; offset < startNodes.size(); offset += maxNodesPerBrowse)
+			{
+				const std::size_t chunkSize = std::min(maxNodesPerBrowse, startNodes.size() - offset);
+
+				UA_BrowseRequest browseRequest;
+				UA_BrowseRequest_init(&browseRequest);
+				UA_BrowseResponse browseResponse;
+				UA_BrowseResponse_init(&browseResponse);
+				ScopeExitGuard browseGuard([&]() {
+					UA_BrowseRequest_clear(&browseRequest);
+					UA_BrowseResponse_clear(&browseResponse);
+				});
+				// Paging takes over the continuation point of a result. If paging or a single browse throws,
+				// the continuation points of the remaining results are released here.
+				ScopeExitGuard continuationPointsGuard([&]() {
+					for (std::size_t i = 0; i < browseResponse.resultsSize; ++i)
+					{
+						const UA_ByteString &continuationPoint = browseResponse.results[i].continuationPoint;
+						if (continuationPoint.length > 0)
+						{
+							std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
+							auto releaseResult = m_opcUaWrapper->SessionBrowseNext(m_pClient.get(), UA_TRUE, continuationPoint);
+							UA_BrowseNextResponse_clear(&releaseResult);
+						}
+					}
+				});
+
+				browseRequest.requestedMaxReferencesPerNode = m_browsePageSize;
+				browseRequest.nodesToBrowse = static_cast<UA_BrowseDescription *>(
+					UA_Array_new(chunkSize, &UA_TYPES[UA_TYPES_BROWSEDESCRIPTION]));
+				browseRequest.nodesToBrowseSize = chunkSize;
+				for (std::size_t i = 0; i < chunkSize; ++i)
+				{
+					auto startUaNodeId = Converter::ModelNodeIdToUaNodeId(startNodes[offset + i], m_namespaceCache.uriToIndex()).getNodeId();
+					UA_BrowseDescription_copy(&uaBrowseContext, &browseRequest.nodesToBrowse[i]);
+					UA_NodeId_copy(startUaNodeId.NodeId, &browseRequest.nodesToBrowse[i].nodeId);
+				}
+
+				{
+					std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
+					browseResponse = m_opcUaWrapper->SessionBrowse(m_pClient.get(), browseRequest);
+				}
+
+				if (UA_StatusCode_isBad(browseResponse.responseHeader.serviceResult))
+				{
+					LOG(ERROR) << "Bad return from browse of " << chunkSize << " nodes: "
+							   << UA_StatusCode_name(browseResponse.responseHeader.serviceResult);
+					throw Exceptions::OpcUaNonGoodStatusCodeException(browseResponse.responseHeader.serviceResult);
+				}
+				if (browseResponse.resultsSize != chunkSize)
+				{
+					LOG(ERROR) << "Expect " << chunkSize << " browse results, got " << browseResponse.resultsSize;
+					throw Exceptions::UmatiException("BrowseResult length mismatch.");
+				}
+
+				for (std::size_t i = 0; i < chunkSize; ++i)
+				{
+					UA_BrowseResult &uaBrowseResult = browseResponse.results[i];
+					if (uaBrowseResult.statusCode == UA_STATUSCODE_BADNOCONTINUATIONPOINTS)
+					{
+						// The server ran out of continuation points for this request, the previous results have
+						// released theirs by now, so browse this node on its own.
+						UA_BrowseDescription singleBrowseContext = getUaBrowseContext(browseContext);
+						browseResults[offset + i] = BrowseWithContextAndFilter(startNodes[offset + i], singleBrowseContext);
+						continue;
+					}
+					if (UA_StatusCode_isBad(uaBrowseResult.statusCode))
+					{
+						LOG(WARNING) << "Bad return from browse with startNode: "
+									 << static_cast<std::string>(startNodes[offset + i])
+									 << " (" << UA_StatusCode_name(uaBrowseResult.statusCode) << ")";
+						unknownNodeIdFound |= uaBrowseResult.statusCode == UA_STATUSCODE_BADNODEIDUNKNOWN;
+						continue;
+					}
+					appendBrowseResultPages(uaBrowseResult, browseResults[offset + i]);
+				}
+			}
+
+			if (unknownNodeIdFound)
+			{
+				LOG(INFO) << "Updating NamespaceCache because of " << UA_StatusCode_name(UA_STATUSCODE_BADNODEIDUNKNOWN);
+				updateNamespaceCache();
+			}
+
+			return browseResults;
+		}
+
 		void OpcUaClient::ReferenceDescriptionsToBrowseResults(
-			const std::vector<UA_ReferenceDescription> &referenceDescriptions,
+			const UA_ReferenceDescription *referenceDescriptions,
+			std::size_t referenceDescriptionsSize,
 			std::list<ModelOpcUa::BrowseResult_t> &browseResult,
 			std::function<bool(const UA_ReferenceDescription &)> filter)
 		{
-				for (UA_Int32 i = 0; i < referenceDescriptions.size(); i++)
+			for (std::size_t i = 0; i < referenceDescriptionsSize; i++)
 			{
-				if (!filter(referenceDescriptions.at(i)))
+				if (!filter(referenceDescriptions[i]))
 				{
-				continue;
+					continue;
 				}
-					UA_ReferenceDescription tmp = referenceDescriptions.at(i);
-					auto entry = ReferenceDescriptionToBrowseResult(tmp);
-					browseResult.push_back(entry);
+				browseResult.push_back(ReferenceDescriptionToBrowseResult(referenceDescriptions[i]));
 			}
 		}
 
-		void OpcUaClient::handleContinuationPoint(const UA_ByteString & /*continuationPoint*/)
+		void OpcUaClient::appendBrowseResultPages(
+			UA_BrowseResult &uaBrowseResult,
+			std::list<ModelOpcUa::BrowseResult_t> &browseResult,
+			std::function<bool(const UA_ReferenceDescription &)> filter)
 		{
-			// LOG(DEBUG) << "Handling continuation point not yet implemented";
+			// Take over the continuation point, it is released on the server if paging is aborted
+			UA_ByteString continuationPoint = uaBrowseResult.continuationPoint;
+			UA_ByteString_init(&uaBrowseResult.continuationPoint);
+			ScopeExitGuard continuationPointGuard([&]() {
+				if (continuationPoint.length > 0)
+				{
+					std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
+					auto releaseResult = m_opcUaWrapper->SessionBrowseNext(m_pClient.get(), UA_TRUE, continuationPoint);
+					UA_BrowseNextResponse_clear(&releaseResult);
+				}
+				UA_ByteString_clear(&continuationPoint);
+			});
+
+			ReferenceDescriptionsToBrowseResults(uaBrowseResult.references, uaBrowseResult.referencesSize, browseResult, filter);
+
+			while (continuationPoint.length > 0)
+			{
+				UA_BrowseNextResponse browseNextResponse;
+				UA_BrowseNextResponse_init(&browseNextResponse);
+				ScopeExitGuard browseNextGuard([&]() {
+					UA_BrowseNextResponse_clear(&browseNextResponse);
+				});
+				{
+					std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
+					browseNextResponse = m_opcUaWrapper->SessionBrowseNext(m_pClient.get(), UA_FALSE, continuationPoint);
+				}
+				// The continuation point is consumed by BrowseNext, regardless of the result
+				UA_ByteString_clear(&continuationPoint);
+
+				UA_StatusCode status = browseNextResponse.responseHeader.serviceResult;
+				if (!UA_StatusCode_isBad(status) && browseNextResponse.resultsSize != 1)
+				{
+					status = UA_STATUSCODE_BADUNEXPECTEDERROR;
+				}
+				if (!UA_StatusCode_isBad(status))
+				{
+					status = browseNextResponse.results->statusCode;
+				}
+				if (UA_StatusCode_isBad(status))
+				{
+					LOG(ERROR) << "BrowseNext failed with " << UA_StatusCode_name(status)
+							   << " after " << browseResult.size() << " references";
+					throw Exceptions::OpcUaNonGoodStatusCodeException(status);
+				}
+
+				UA_BrowseResult &page = *browseNextResponse.results;
+				ReferenceDescriptionsToBrowseResults(page.references, page.referencesSize, browseResult, filter);
+				continuationPoint = page.continuationPoint;
+				UA_ByteString_init(&page.continuationPoint);
+			}
 		}
 
 		ModelOpcUa::BrowseResult_t
@@ -651,23 +1148,23 @@ namespace Umati
 			UA_NodeId_copy(&referenceDescription.typeDefinition.nodeId, browseTypeUaNodeId.NodeId);
 
 			entry.NodeClass = Converter::UaNodeClassToModelNodeClass(referenceDescription.nodeClass).getNodeClass();
-			entry.TypeDefinition = Converter::UaNodeIdToModelNodeId(browseTypeUaNodeId,m_indexToUriCache).getNodeId();
+			entry.TypeDefinition = Converter::UaNodeIdToModelNodeId(browseTypeUaNodeId,m_namespaceCache.indexToUri()).getNodeId();
 
 			open62541Cpp::UA_NodeId referenceDescriptionTmp;
 			UA_NodeId_copy(&referenceDescription.nodeId.nodeId, referenceDescriptionTmp.NodeId);
-			entry.NodeId = Converter::UaNodeIdToModelNodeId(referenceDescriptionTmp, m_indexToUriCache).getNodeId();
+			entry.NodeId = Converter::UaNodeIdToModelNodeId(referenceDescriptionTmp, m_namespaceCache.indexToUri()).getNodeId();
 
 			open62541Cpp::UA_NodeId referenceTypeUaNodeId;
 			UA_NodeId_copy(&referenceDescription.referenceTypeId, referenceTypeUaNodeId.NodeId);
 
-			auto referenceTypeModelNodeId = Converter::UaNodeIdToModelNodeId(referenceTypeUaNodeId,m_indexToUriCache).getNodeId();
+			auto referenceTypeModelNodeId = Converter::UaNodeIdToModelNodeId(referenceTypeUaNodeId,m_namespaceCache.indexToUri()).getNodeId();
 
 			entry.ReferenceTypeId = referenceTypeModelNodeId;
 			open62541Cpp::UA_QualifiedName browseName(referenceDescription.browseName.namespaceIndex,
 														std::string((char*)referenceDescription.browseName.name.data,
 														referenceDescription.browseName.name.length));
 
-			entry.BrowseName = Converter::UaQualifiedNameToModelQualifiedName(browseName,m_indexToUriCache).getQualifiedName();
+			entry.BrowseName = Converter::UaQualifiedNameToModelQualifiedName(browseName,m_namespaceCache.indexToUri()).getQualifiedName();
 
 			return entry;
 		}
@@ -675,7 +1172,7 @@ namespace Umati
 		UA_BrowseDescription OpcUaClient::prepareBrowseContext(ModelOpcUa::NodeId_t referenceTypeId)
 		{
 			auto referenceTypeUaNodeId = Converter::ModelNodeIdToUaNodeId(std::move(referenceTypeId),
-																		  m_uriToIndexCache)
+																		  m_namespaceCache.uriToIndex())
 											 .getNodeId();
 			UA_BrowseDescription browseContext;
             UA_BrowseDescription_init(&browseContext);
@@ -700,7 +1197,7 @@ namespace Umati
 
 			if(!browseContext.referenceTypeId.isNull())
 			{
-				ret.referenceTypeId = *Converter::ModelNodeIdToUaNodeId(browseContext.referenceTypeId, m_uriToIndexCache).getNodeId().NodeId;
+				ret.referenceTypeId = *Converter::ModelNodeIdToUaNodeId(browseContext.referenceTypeId, m_namespaceCache.uriToIndex()).getNodeId().NodeId;
 			}else{
 				UA_NodeId_clear(&ret.referenceTypeId);
 			}
@@ -727,11 +1224,11 @@ namespace Umati
 			}
 
 			auto startUaNodeId = Converter::ModelNodeIdToUaNodeId(startNode,
-																  m_uriToIndexCache)
+																  m_namespaceCache.uriToIndex())
 																  .getNodeId();
 
 			auto uaBrowseName = Converter::ModelQualifiedNameToUaQualifiedName(browseName,
-																			   m_uriToIndexCache)
+																			   m_namespaceCache.uriToIndex())
 																			   .detach();
 
 			UA_BrowsePath uaBrowsePaths;
@@ -753,7 +1250,7 @@ namespace Umati
 				UA_BrowsePath_clear(&uaBrowsePaths);
 			});
 			{
-            std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+            std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
 			uaResult = m_opcUaWrapper->SessionTranslateBrowsePathsToNodeIds(
 				m_pClient.get(),
 				uaBrowsePaths,
@@ -806,7 +1303,7 @@ namespace Umati
 					try
 					{
 						open62541Cpp::UA_NodeId _targetNodeId(uaBrowsePathResults.targets->targetId.nodeId);
-						auto nodeId = Converter::UaNodeIdToModelNodeId(_targetNodeId, m_indexToUriCache).getNodeId();
+						auto nodeId = Converter::UaNodeIdToModelNodeId(_targetNodeId, m_namespaceCache.indexToUri()).getNodeId();
 						LOG(WARNING) << "Target " << target_id << " | id: " << nodeId.Uri << ";" << nodeId.Id;
 					}
 					catch (std::exception &ex)
@@ -818,13 +1315,181 @@ namespace Umati
 
 			open62541Cpp::UA_NodeId targetNodeId(uaBrowsePathResults.targets->targetId.nodeId);
 
-			return Converter::UaNodeIdToModelNodeId(targetNodeId, m_indexToUriCache).getNodeId();
+			return Converter::UaNodeIdToModelNodeId(targetNodeId, m_namespaceCache.indexToUri()).getNodeId();
 			}
 
+		std::vector<std::vector<std::size_t>> OpcUaClient::translateRequestChunks(
+			const std::vector<ModelOpcUa::QualifiedName_t> &browseNames,
+			std::vector<TranslateBrowsePathResult_t> &translateResults)
+		{
+			const std::size_t maxNodesPerTranslate = m_maxNodesPerTranslateBrowsePaths;
+			std::vector<std::vector<std::size_t>> chunks;
+			for (std::size_t offset = 0; offset < browseNames.size(); offset += maxNodesPerTranslate)
+			{
+				// Null browse names are not sent to the server
+				std::vector<std::size_t> requestIndices;
+				for (std::size_t i = offset; i < std::min(offset + maxNodesPerTranslate, browseNames.size()); ++i)
+				{
+					if (browseNames[i].isNull())
+					{
+						LOG(ERROR) << "browseName is NULL";
+						translateResults[i].Error = "browseName is NULL";
+						continue;
+					}
+					requestIndices.push_back(i);
+				}
+				if (!requestIndices.empty())
+				{
+					chunks.push_back(std::move(requestIndices));
+				}
+			}
+			return chunks;
+		}
+
+		void OpcUaClient::prepareTranslateRequest(UA_TranslateBrowsePathsToNodeIdsRequest &request,
+												  const open62541Cpp::UA_NodeId &startUaNodeId,
+												  const std::vector<ModelOpcUa::QualifiedName_t> &browseNames,
+												  const std::vector<std::size_t> &requestIndices)
+		{
+			request.browsePaths = static_cast<UA_BrowsePath *>(
+				UA_Array_new(requestIndices.size(), &UA_TYPES[UA_TYPES_BROWSEPATH]));
+			request.browsePathsSize = requestIndices.size();
+			for (std::size_t iPath = 0; iPath < requestIndices.size(); ++iPath)
+			{
+				UA_BrowsePath &uaBrowsePath = request.browsePaths[iPath];
+				UA_NodeId_copy(startUaNodeId.NodeId, &uaBrowsePath.startingNode);
+				uaBrowsePath.relativePath.elementsSize = 1;
+				uaBrowsePath.relativePath.elements = UA_RelativePathElement_new();
+				uaBrowsePath.relativePath.elements->includeSubtypes = UA_TRUE;
+				uaBrowsePath.relativePath.elements->isInverse = UA_FALSE;
+				uaBrowsePath.relativePath.elements->referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HIERARCHICALREFERENCES);
+				uaBrowsePath.relativePath.elements->targetName =
+					Converter::ModelQualifiedNameToUaQualifiedName(browseNames[requestIndices[iPath]], m_namespaceCache.uriToIndex()).detach();
+			}
+		}
+
+		bool OpcUaClient::translateResponseToResults(const ModelOpcUa::NodeId_t &startNode,
+													 const std::vector<ModelOpcUa::QualifiedName_t> &browseNames,
+													 const std::vector<std::size_t> &requestIndices,
+													 const UA_TranslateBrowsePathsToNodeIdsResponse &response,
+													 std::vector<TranslateBrowsePathResult_t> &translateResults)
+		{
+			bool unknownNodeIdFound = false;
+			if (UA_StatusCode_isBad(response.responseHeader.serviceResult))
+			{
+				LOG(ERROR) << "TranslateBrowsePathsToNodeIds failed for node: '" << static_cast<std::string>(startNode)
+						   << "' with " << UA_StatusCode_name(response.responseHeader.serviceResult);
+				throw Exceptions::OpcUaNonGoodStatusCodeException(response.responseHeader.serviceResult);
+			}
+			if (response.resultsSize != requestIndices.size())
+			{
+				LOG(ERROR) << "Expect " << requestIndices.size() << " BrowsePathResults, got " << response.resultsSize
+						   << " for node: '" << static_cast<std::string>(startNode) << "'";
+				throw Exceptions::UmatiException("BrowsePathResult length mismatch.");
+			}
+
+			for (std::size_t iPath = 0; iPath < requestIndices.size(); ++iPath)
+			{
+				const UA_BrowsePathResult &uaBrowsePathResult = response.results[iPath];
+				const auto &browseName = browseNames[requestIndices[iPath]];
+				auto &translateResult = translateResults[requestIndices[iPath]];
+
+				if (UA_StatusCode_isBad(uaBrowsePathResult.statusCode))
+				{
+					// BadNoMatch is the regular result for an absent optional child
+					if (uaBrowsePathResult.statusCode != UA_STATUSCODE_BADNOMATCH)
+					{
+						LOG(ERROR) << "TranslateBrowsePathToNodeId failed for node: '" << static_cast<std::string>(startNode)
+								   << "' with " << UA_StatusCode_name(uaBrowsePathResult.statusCode) << "(BrowsePath: "
+								   << static_cast<std::string>(browseName) << ")";
+					}
+					unknownNodeIdFound |= uaBrowsePathResult.statusCode == UA_STATUSCODE_BADNODEIDUNKNOWN;
+					std::stringstream ss;
+					ss << "Element returned bad status code: " << UA_StatusCode_name(uaBrowsePathResult.statusCode)
+					   << " for node: '" << static_cast<std::string>(startNode)
+					   << "' (BrowsePath: " << static_cast<std::string>(browseName) << ")";
+					translateResult.Error = ss.str();
+					continue;
+				}
+
+				if (uaBrowsePathResult.targetsSize == 0)
+				{
+					LOG(ERROR) << "Expect 1 browseResult, got 0 for node: '" << static_cast<std::string>(startNode)
+							   << "' (BrowsePath: " << static_cast<std::string>(browseName) << ")";
+					translateResult.Error = "BrowseResult length mismatch.";
+					continue;
+				}
+				if (uaBrowsePathResult.targetsSize > 1)
+				{
+					LOG(WARNING) << "Continuing with index 0 - expected one target, got "
+								 << uaBrowsePathResult.targetsSize
+								 << " for node: '" << static_cast<std::string>(startNode)
+								 << "' (BrowsePath: " << static_cast<std::string>(browseName) << ")";
+				}
+
+				open62541Cpp::UA_NodeId targetNodeId(uaBrowsePathResult.targets->targetId.nodeId);
+				translateResult.TargetNodeId = Converter::UaNodeIdToModelNodeId(targetNodeId, m_namespaceCache.indexToUri()).getNodeId();
+			}
+			return unknownNodeIdFound;
+		}
+
+		std::vector<Dashboard::IDashboardDataClient::TranslateBrowsePathResult_t>
+		OpcUaClient::TranslateBrowsePathsToNodeIds(const ModelOpcUa::NodeId_t &startNode,
+												   const std::vector<ModelOpcUa::QualifiedName_t> &browseNames)
+		{
+			std::vector<TranslateBrowsePathResult_t> translateResults(browseNames.size());
+			if (browseNames.empty())
+			{
+				return translateResults;
+			}
+
+			checkConnection();
+
+			if (startNode.isNull())
+			{
+				LOG(ERROR) << "startNode is NULL";
+				throw std::invalid_argument("startNode is NULL");
+			}
+
+			auto startUaNodeId = Converter::ModelNodeIdToUaNodeId(startNode,
+																  m_namespaceCache.uriToIndex())
+																  .getNodeId();
+
+			bool unknownNodeIdFound = false;
+			for (const auto &requestIndices : translateRequestChunks(browseNames, translateResults))
+			{
+				UA_TranslateBrowsePathsToNodeIdsRequest request;
+				UA_TranslateBrowsePathsToNodeIdsRequest_init(&request);
+				UA_TranslateBrowsePathsToNodeIdsResponse response;
+				UA_TranslateBrowsePathsToNodeIdsResponse_init(&response);
+				ScopeExitGuard translateGuard([&]() {
+					UA_TranslateBrowsePathsToNodeIdsRequest_clear(&request);
+					UA_TranslateBrowsePathsToNodeIdsResponse_clear(&response);
+				});
+
+				prepareTranslateRequest(request, startUaNodeId, browseNames, requestIndices);
+
+				{
+					std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
+					response = m_opcUaWrapper->SessionTranslateBrowsePathsToNodeIds(m_pClient.get(), request);
+				}
+
+				unknownNodeIdFound |= translateResponseToResults(startNode, browseNames, requestIndices, response, translateResults);
+			}
+
+			if (unknownNodeIdFound)
+			{
+				LOG(INFO) << "Updating NamespaceCache because of " << UA_StatusCode_name(UA_STATUSCODE_BADNODEIDUNKNOWN);
+				updateNamespaceCache();
+			}
+
+			return translateResults;
+		}
+
 		std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>
 		OpcUaClient::Subscribe(ModelOpcUa::NodeId_t nodeId, newValueCallbackFunction_t callback)
 		{
-			std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+			std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
 
 			try{
 				return m_opcUaWrapper->SubscriptionSubscribe(m_pClient.get(), nodeId, callback);
@@ -835,12 +1500,44 @@ namespace Umati
 			return nullptr;
 		}
 
+		std::vector<std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>>
+		OpcUaClient::SubscribeMany(const std::vector<ModelOpcUa::NodeId_t> &nodeIds,
+								   const std::vector<newValueCallbackFunction_t> &callbacks,
+								   double samplingInterval_ms)
+		{
+			std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
+
+			try{
+				return m_opcUaWrapper->SubscriptionSubscribeMany(m_pClient.get(), nodeIds, callbacks, m_maxMonitoredItemsPerCall,
+																	 samplingInterval_ms);
+			}catch(std::exception &ex){
+				LOG(ERROR) << "Updating Namespace cache after exception: "<< ex.what();
+				updateNamespaceCache();
+			}
+			return std::vector<std::shared_ptr<ValueSubscriptionHandle>>(nodeIds.size());
+		}
+
 		void OpcUaClient::Unsubscribe(std::vector<int32_t> monItemIds, std::vector<int32_t> clientHandles){
 
-			std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+			std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
 			m_opcUaWrapper->SubscriptionUnsubscribe(m_pClient.get(), monItemIds, clientHandles);
 		}
 
+		std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>
+		OpcUaClient::SubscribeModelChanges(modelChangeCallbackFunction_t callback)
+		{
+			std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
+			try
+			{
+				return m_opcUaWrapper->SubscriptionSubscribeModelChanges(m_pClient.get(), std::move(callback));
+			}
+			catch (const Umati::Exceptions::UmatiException &ex)
+			{
+				LOG(INFO) << "Model change events not available: " << ex.what();
+			}
+			return nullptr;
+		}
+
 		std::vector<nlohmann::json> OpcUaClient::ReadeNodeValues(std::list<ModelOpcUa::NodeId_t> modelNodeIds)
 		{
 			return readValues2(modelNodeIds);
@@ -850,60 +1547,294 @@ namespace Umati
 		{
 
 			std::vector<nlohmann::json> readValues;
+			readValues.reserve(modelNodeIds.size());
 
-			UA_DiagnosticInfo info;
-			UA_DiagnosticInfo_init(&info);
+			// Split into several Read calls, if the server limits the number of nodes per call
+			const std::size_t maxNodesPerRead = m_maxNodesPerRead;
+			auto chunkBegin = modelNodeIds.begin();
+			while (chunkBegin != modelNodeIds.end())
+			{
+				const size_t readValueSize = std::min<std::size_t>(maxNodesPerRead,
+					static_cast<std::size_t>(std::distance(chunkBegin, modelNodeIds.end())));
+				const bool isFirstChunk = chunkBegin == modelNodeIds.begin();
 
-			const size_t readValueSize = modelNodeIds.size();
-			UA_ReadValueId *readValueId = (UA_ReadValueId *) UA_Array_new(readValueSize, &UA_TYPES[UA_TYPES_READVALUEID]);
+				UA_DiagnosticInfo info;
+				UA_DiagnosticInfo_init(&info);
 
+				UA_ReadValueId *readValueId = (UA_ReadValueId *) UA_Array_new(readValueSize, &UA_TYPES[UA_TYPES_READVALUEID]);
 
-			auto index = 0;
-			for (const auto &modelNodeId : modelNodeIds)
-			{
-				open62541Cpp::UA_NodeId nodeId = Converter::ModelNodeIdToUaNodeId(modelNodeId, m_uriToIndexCache).getNodeId();
+				for (std::size_t index = 0; index < readValueSize; ++index, ++chunkBegin)
+				{
+					open62541Cpp::UA_NodeId nodeId = Converter::ModelNodeIdToUaNodeId(*chunkBegin, m_namespaceCache.uriToIndex()).getNodeId();
+
+					readValueId[index].attributeId = UA_ATTRIBUTEID_VALUE;
+					UA_NodeId_copy(nodeId.NodeId, &readValueId[index].nodeId);
+				}
+
+				UA_ReadResponse ret;
+				{
+					std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
+					ret = m_opcUaWrapper->SessionRead(m_pClient.get(),0.0,UA_TIMESTAMPSTORETURN_BOTH, readValueId,  readValueSize, info);
+				}
+				ScopeExitGuard readGuard([&]() {
+					UA_Array_delete(readValueId, readValueSize, &UA_TYPES[UA_TYPES_READVALUEID]);
+					UA_ReadResponse_clear(&ret);
+				});
+
+				if (UA_StatusCode_isBad(ret.responseHeader.serviceResult) || ret.resultsSize != readValueSize)
+				{
+					std::stringstream ss;
+					ss << "Reading " << readValueSize << " nodes failed with: " << UA_StatusCode_name(ret.responseHeader.serviceResult);
+					LOG(ERROR) << ss.str();
+					throw Exceptions::OpcUaException(ss.str());
+				}
+				// Only the status of the very first node is checked, as for a single Read call
+				if (isFirstChunk && UA_StatusCode_isBad(ret.results->status))
+				{
+					std::stringstream ss;
+					ss << "Received non good status for reading: " << UA_StatusCode_name(ret.results->status);
+					LOG(ERROR) << ss.str();
+					throw Exceptions::OpcUaException(ss.str());
+				}
+
+				for(std::size_t i = 0; i < ret.resultsSize; i++){
 
-				readValueId[index].attributeId = UA_ATTRIBUTEID_VALUE;
-				UA_NodeId_copy(nodeId.NodeId, &readValueId[index].nodeId);
-				index++;
+					auto valu = Converter::UaDataValueToJsonValue(ret.results[i], false);
+					auto val = valu.getValue();
+					readValues.push_back(val);
+				}
 			}
 
-			std::lock_guard<std::recursive_mutex> l(m_clientMutex);
-			auto ret = m_opcUaWrapper->SessionRead(m_pClient.get(),0.0,UA_TIMESTAMPSTORETURN_BOTH, readValueId,  readValueSize, info);
+			return readValues;
+		}
 
-			if (UA_StatusCode_isBad(ret.results->status))
+		void OpcUaClient::sendAsyncRequest(const void *request,
+										   const UA_DataType *requestType,
+										   const UA_DataType *responseType,
+										   std::function<void(void *)> onResponse,
+										   std::function<void(std::exception_ptr)> onError)
+		{
+			auto pAsyncRequest = new AsyncRequest_t{std::move(onResponse), std::move(onError)};
+			UA_StatusCode status;
 			{
-				std::stringstream ss;
-				ss << "Received non good status for reading: " << UA_StatusCode_name(ret.results->status);
-				LOG(ERROR) << ss.str();
-				UA_Array_delete(readValueId, readValueSize, &UA_TYPES[UA_TYPES_READVALUEID]);
-				UA_ReadResponse_clear(&ret);
+				std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
+				status = m_isConnected
+					? m_opcUaWrapper->SessionSendAsyncRequest(m_pClient.get(), request, requestType,
+															  &OpcUaClient::asyncServiceCallback, responseType, pAsyncRequest)
+					: UA_STATUSCODE_BADSERVERNOTCONNECTED;
+			}
+			if (UA_StatusCode_isBad(status))
+			{
+				// The callback is only called for requests that have been sent
+				std::unique_ptr<AsyncRequest_t> guard(pAsyncRequest);
+				LOG(ERROR) << "Could not send asynchronous " << requestType->typeName << ": " << UA_StatusCode_name(status);
+				guard->onError(std::make_exception_ptr(Exceptions::OpcUaNonGoodStatusCodeException(status)));
+			}
+		}
 
-				throw Exceptions::OpcUaException(ss.str());
+		void OpcUaClient::asyncServiceCallback(UA_Client *client, void *userdata, UA_UInt32 requestId, void *response)
+		{
+			std::unique_ptr<AsyncRequest_t> pAsyncRequest(static_cast<AsyncRequest_t *>(userdata));
+			try
+			{
+				if (response == nullptr)
+				{
+					throw Exceptions::UmatiException("Asynchronous request without response.");
+				}
+				// All responses start with the response header
+				UA_StatusCode status = static_cast<UA_ResponseHeader *>(response)->serviceResult;
+				if (UA_StatusCode_isBad(status))
+				{
+					throw Exceptions::OpcUaNonGoodStatusCodeException(status);
+				}
+				pAsyncRequest->onResponse(response);
 			}
-			else
+			catch (...)
 			{
-				for(int i = 0; i < ret.resultsSize; i++){
+				pAsyncRequest->onError(std::current_exception());
+			}
+		}
 
-					auto valu = Converter::UaDataValueToJsonValue(ret.results[i], false);
-					auto val = valu.getValue();
-					readValues.push_back(val);
+		std::future<std::vector<nlohmann::json>> OpcUaClient::ReadAsync(std::list<ModelOpcUa::NodeId_t> modelNodeIds)
+		{
+			struct ReadState_t
+			{
+				std::promise<std::vector<nlohmann::json>> Promise;
+				std::vector<nlohmann::json> Values;
+				std::size_t OutstandingRequests = 0;
+				bool Failed = false;
+			};
+			auto pState = std::make_shared<ReadState_t>();
+			auto future = pState->Promise.get_future();
+			if (modelNodeIds.empty())
+			{
+				pState->Promise.set_value({});
+				return future;
+			}
+			pState->Values.resize(modelNodeIds.size());
+
+			// Same chunks as readValues2, all of them are in flight together
+			const std::size_t maxNodesPerRead = m_maxNodesPerRead;
+			std::vector<UA_ReadRequest> requests;
+			ScopeExitGuard readGuard([&]() {
+				for (auto &request : requests)
+				{
+					UA_ReadRequest_clear(&request);
+				}
+			});
+			auto modelNodeId = modelNodeIds.begin();
+			while (modelNodeId != modelNodeIds.end())
+			{
+				const std::size_t chunkSize = std::min<std::size_t>(maxNodesPerRead,
+					static_cast<std::size_t>(std::distance(modelNodeId, modelNodeIds.end())));
+				requests.emplace_back();
+				UA_ReadRequest &readRequest = requests.back();
+				UA_ReadRequest_init(&readRequest);
+				readRequest.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+				readRequest.nodesToRead = static_cast<UA_ReadValueId *>(UA_Array_new(chunkSize, &UA_TYPES[UA_TYPES_READVALUEID]));
+				readRequest.nodesToReadSize = chunkSize;
+				for (std::size_t index = 0; index < chunkSize; ++index, ++modelNodeId)
+				{
+					auto nodeId = Converter::ModelNodeIdToUaNodeId(*modelNodeId, m_namespaceCache.uriToIndex()).getNodeId();
+					readRequest.nodesToRead[index].attributeId = UA_ATTRIBUTEID_VALUE;
+					UA_NodeId_copy(nodeId.NodeId, &readRequest.nodesToRead[index].nodeId);
 				}
 			}
 
-			for(int i = 0; i < readValueSize; i++){
-				UA_NodeId_clear(&readValueId[i].nodeId);
+			// All chunks are sent before the first response is processed, responses are handled with the client locked
+			std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
+			pState->OutstandingRequests = requests.size();
+			std::size_t offset = 0;
+			for (auto &readRequest : requests)
+			{
+				const std::size_t chunkSize = readRequest.nodesToReadSize;
+				sendAsyncRequest(&readRequest, &UA_TYPES[UA_TYPES_READREQUEST], &UA_TYPES[UA_TYPES_READRESPONSE],
+					[pState, offset, chunkSize](void *response) {
+						--pState->OutstandingRequests;
+						if (pState->Failed)
+						{
+							return;
+						}
+						auto &readResponse = *static_cast<UA_ReadResponse *>(response);
+						if (readResponse.resultsSize != chunkSize)
+						{
+							throw Exceptions::UmatiException("ReadResult length mismatch.");
+						}
+						// Same semantic as ReadeNodeValues, only the status of the very first node is checked
+						if (offset == 0 && UA_StatusCode_isBad(readResponse.results->status))
+						{
+							std::stringstream ss;
+							ss << "Received non good status for reading: " << UA_StatusCode_name(readResponse.results->status);
+							throw Exceptions::OpcUaException(ss.str());
+						}
+						for (std::size_t i = 0; i < readResponse.resultsSize; ++i)
+						{
+							pState->Values[offset + i] = Converter::UaDataValueToJsonValue(readResponse.results[i], false).getValue();
+						}
+						if (pState->OutstandingRequests == 0)
+						{
+							pState->Promise.set_value(std::move(pState->Values));
+						}
+					},
+					[pState](std::exception_ptr ex) {
+						// The first error fails the whole read, later responses are ignored
+						if (!pState->Failed)
+						{
+							pState->Failed = true;
+							pState->Promise.set_exception(ex);
+						}
+					});
+				offset += chunkSize;
 			}
-			UA_Array_delete(readValueId, readValueSize, &UA_TYPES[UA_TYPES_READVALUEID]);
-			UA_ReadResponse_clear(&ret);
 
-			return readValues;
+			return future;
+		}
+
+		std::future<std::vector<Dashboard::IDashboardDataClient::TranslateBrowsePathResult_t>>
+		OpcUaClient::TranslateAsync(const ModelOpcUa::NodeId_t &startNode,
+									const std::vector<ModelOpcUa::QualifiedName_t> &browseNames)
+		{
+			struct TranslateState_t
+			{
+				std::promise<std::vector<TranslateBrowsePathResult_t>> Promise;
+				std::vector<TranslateBrowsePathResult_t> Results;
+				std::size_t OutstandingRequests = 0;
+				bool Failed = false;
+			};
+			auto pState = std::make_shared<TranslateState_t>();
+			auto future = pState->Promise.get_future();
+			pState->Results.resize(browseNames.size());
+			if (browseNames.empty())
+			{
+				pState->Promise.set_value({});
+				return future;
+			}
+
+			if (startNode.isNull())
+			{
+				pState->Promise.set_exception(std::make_exception_ptr(std::invalid_argument("startNode is NULL")));
+				return future;
+			}
+
+			auto chunks = translateRequestChunks(browseNames, pState->Results);
+			if (chunks.empty())
+			{
+				pState->Promise.set_value(std::move(pState->Results));
+				return future;
+			}
+
+			auto startUaNodeId = Converter::ModelNodeIdToUaNodeId(startNode, m_namespaceCache.uriToIndex()).getNodeId();
+			auto pBrowseNames = std::make_shared<const std::vector<ModelOpcUa::QualifiedName_t>>(browseNames);
+
+			// All chunks are sent before the first response is processed, responses are handled with the client locked
+			std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
+			pState->OutstandingRequests = chunks.size();
+			for (auto &requestIndices : chunks)
+			{
+				UA_TranslateBrowsePathsToNodeIdsRequest request;
+				UA_TranslateBrowsePathsToNodeIdsRequest_init(&request);
+				ScopeExitGuard translateGuard([&]() {
+					UA_TranslateBrowsePathsToNodeIdsRequest_clear(&request);
+				});
+				prepareTranslateRequest(request, startUaNodeId, browseNames, requestIndices);
+
+				auto pRequestIndices = std::make_shared<const std::vector<std::size_t>>(std::move(requestIndices));
+				sendAsyncRequest(&request, &UA_TYPES[UA_TYPES_TRANSLATEBROWSEPATHSTONODEIDSREQUEST],
+								 &UA_TYPES[UA_TYPES_TRANSLATEBROWSEPATHSTONODEIDSRESPONSE],
+					[this, pState, startNode, pBrowseNames, pRequestIndices](void *response) {
+						--pState->OutstandingRequests;
+						if (pState->Failed)
+						{
+							return;
+						}
+						auto &translateResponse = *static_cast<UA_TranslateBrowsePathsToNodeIdsResponse *>(response);
+						if (translateResponseToResults(startNode, *pBrowseNames, *pRequestIndices, translateResponse, pState->Results))
+						{
+							m_namespaceCacheOutdated = true;
+						}
+						if (pState->OutstandingRequests == 0)
+						{
+							pState->Promise.set_value(std::move(pState->Results));
+						}
+					},
+					[pState](std::exception_ptr ex) {
+						// The first error fails the whole translation, later responses are ignored
+						if (!pState->Failed)
+						{
+							pState->Failed = true;
+							pState->Promise.set_exception(ex);
+						}
+					});
+			}
+
+			return future;
 		}
 
 		std::vector<std::string> OpcUaClient::Namespaces()
 		{
 			std::vector<std::string> ret;
-			for(auto &ns : m_indexToUriCache)
+			auto indexToUriCache = m_namespaceCache.indexToUri();
+			for(auto &ns : indexToUriCache.get())
 			{
 				ret.push_back(ns.second);
 			}
@@ -911,7 +1842,7 @@ namespace Umati
 		}
 
 		bool OpcUaClient::VerifyConnection() {
-			std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+			std::lock_guard<decltype(m_clientMutex)> l(m_clientMutex);
 			UA_NodeClass nodeClass = UA_NodeClass::UA_NODECLASS_OBJECT;
 			auto status = UA_Client_readNodeClassAttribute(m_pClient.get(), UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_NAMESPACEARRAY), &nodeClass);
 			if(status != UA_STATUSCODE_GOOD) {
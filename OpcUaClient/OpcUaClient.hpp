@@ -25,10 +25,18 @@
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <chrono>
+#include <map>
+#include <set>
+#include <future>
 #include "ModelOpcUa/ModelDefinition.hpp"
 #include "ModelOpcUa/ModelInstance.hpp"
 
 #include "Subscription.hpp"
+#include "ClientMutex.hpp"
+#include "NamespaceCache.hpp"
+#include "SuperTypeCache.hpp"
+#include "RuntimeDataTypes.hpp"
 #include "OpcUaInterface.hpp"
 #include <functional>
 
@@ -45,7 +53,10 @@ namespace Umati
 								 std::string Password = std::string(), std::uint8_t security = 1,
 								 std::vector<std::string> expectedObjectTypeNamespaces = std::vector<std::string>(),
 								 std::shared_ptr<Umati::OpcUa::OpcUaInterface> opcUaWrapper = std::make_shared<Umati::OpcUa::OpcUaWrapper>(),
-								 bool bypassCertVerification = false);
+								 bool bypassCertVerification = false,
+								 std::uint32_t browsePageSize = 1000,
+								 std::uint32_t maxMonitoredItemsPerCall = 500,
+								 std::shared_ptr<SuperTypeCache> superTypeCache = nullptr);
 			~OpcUaClient() ;
 
 			bool disconnect();
@@ -56,6 +67,10 @@ namespace Umati
 				ModelOpcUa::NodeId_t startNode,
 				BrowseContext_t browseContext) override;
 
+			std::vector<std::list<ModelOpcUa::BrowseResult_t>> BrowseMany(
+				const std::vector<ModelOpcUa::NodeId_t> &startNodes,
+				BrowseContext_t browseContext) override;
+
 			std::list<ModelOpcUa::BrowseResult_t>
 			BrowseWithResultTypeFilter(
 				ModelOpcUa::NodeId_t startNode,
@@ -66,13 +81,30 @@ namespace Umati
 			TranslateBrowsePathToNodeId(ModelOpcUa::NodeId_t startNode,
 												 ModelOpcUa::QualifiedName_t browseName) override;
 
+			std::vector<TranslateBrowsePathResult_t>
+			TranslateBrowsePathsToNodeIds(const ModelOpcUa::NodeId_t &startNode,
+												 const std::vector<ModelOpcUa::QualifiedName_t> &browseNames) override;
+
 			std::shared_ptr<ValueSubscriptionHandle>
 			Subscribe(ModelOpcUa::NodeId_t nodeId, newValueCallbackFunction_t callback) override;
 
+			std::vector<std::shared_ptr<ValueSubscriptionHandle>>
+			SubscribeMany(const std::vector<ModelOpcUa::NodeId_t> &nodeIds,
+						  const std::vector<newValueCallbackFunction_t> &callbacks,
+						  double samplingInterval_ms = DefaultSamplingInterval_ms) override;
+
 			void Unsubscribe(std::vector<int32_t>monItemIds, std::vector<int32_t> clientHandle) override;
 
+			std::shared_ptr<ValueSubscriptionHandle> SubscribeModelChanges(modelChangeCallbackFunction_t callback) override;
+
 			std::vector<nlohmann::json> ReadeNodeValues(std::list<ModelOpcUa::NodeId_t> modelNodeIds) override;
 
+			std::future<std::vector<nlohmann::json>> ReadAsync(std::list<ModelOpcUa::NodeId_t> modelNodeIds) override;
+
+			std::future<std::vector<TranslateBrowsePathResult_t>>
+			TranslateAsync(const ModelOpcUa::NodeId_t &startNode,
+						   const std::vector<ModelOpcUa::QualifiedName_t> &browseNames) override;
+
 			std::string readNodeBrowseName(const ModelOpcUa::NodeId_t &_nodeId) override;
 
 			std::string getTypeName(const ModelOpcUa::NodeId_t &nodeId) override;
@@ -83,6 +115,10 @@ namespace Umati
 
             bool isSameOrSubtype(const ModelOpcUa::NodeId_t &expectedType, const ModelOpcUa::NodeId_t &checkType,
                                  size_t maxDepth) override;
+
+			/// Fill the supertype cache with the HasSubtype trees below rootTypes, browsing one tree level at once.
+			/// Stops when the cache is full, types not prefetched are still browsed on demand.
+			void prefetchSubtypes(const std::vector<ModelOpcUa::NodeId_t> &rootTypes);
 		protected:
 			void connectionStatusChanged(UA_Int32 clientConnectionId, UA_ServerState serverStatus);
 
@@ -99,6 +135,21 @@ namespace Umati
 
 			double m_maxAgeRead_ms = 100.0;
 
+			/// Used when the server does not announce an operation limit
+			static constexpr std::size_t DefaultMaxNodesPerBrowse = 500;
+			static constexpr std::size_t DefaultMaxNodesPerRead = 1000;
+
+			/// Read one of the Server_ServerCapabilities_OperationLimits variables, 0 (no limit) yields defaultLimit
+			std::size_t readOperationLimit(UA_UInt32 operationLimitNodeId, std::size_t defaultLimit);
+
+			std::atomic<std::size_t> m_maxNodesPerBrowse = {DefaultMaxNodesPerBrowse};
+			std::atomic<std::size_t> m_maxNodesPerTranslateBrowsePaths = {DefaultMaxNodesPerBrowse};
+			/// Chunk size for ReadeNodeValues
+			std::atomic<std::size_t> m_maxNodesPerRead = {DefaultMaxNodesPerRead};
+			/// Chunk size for CreateMonitoredItems, configured value capped by the server's MaxMonitoredItemsPerCall
+			std::atomic<std::size_t> m_maxMonitoredItemsPerCall;
+			const std::size_t m_configuredMaxMonitoredItemsPerCall;
+
 			void updateNamespaceCache();
 			/// Ensure that the new namespace chache is compatible to the current class state.
 			/// Verifies, that no namespace has been removed, or reordered.
@@ -106,49 +157,111 @@ namespace Umati
 
 			void threadConnectExecution();
 
+			/// Loads the definitions of the structures that the converter could not decode
+			void loadUnknownDataTypes();
+			/// Follows the inverse HasEncoding reference of an encoding node
+			/// \return false if the server does not describe the data type, throws if the Browse failed
+			bool browseDataTypeOfEncoding(const UA_NodeId &encodingId, UA_NodeId &dataTypeId);
+			/// Reads the DataTypeDefinition and creates the descriptor, including unknown field types
+			/// \return nullptr if the data type is not supported, throws if a Read failed
+			const UA_DataType *loadDataType(const UA_NodeId &dataTypeId, std::size_t depth);
+			/// Descriptor of a field type from namespace 0, abstract types are decoded as Variant or ExtensionObject
+			static const UA_DataType *findNs0FieldType(const UA_NodeId &dataTypeId);
+
 			std::function<void()> m_issueReset;
-			std::map<uint16_t, std::string> m_indexToUriCache;
+			NamespaceCache m_namespaceCache;
 			std::string m_serverUri;
 			std::string m_username;
 			std::string m_password;
 			UA_MessageSecurityMode m_security = UA_MESSAGESECURITYMODE_NONE;
+			/// requestedMaxReferencesPerNode for Browse, further references are fetched with BrowseNext
+			UA_UInt32 m_browsePageSize;
 			UA_DataTypeArray m_dataTypeArray;
 
 			std::shared_ptr<std::thread> m_connectThread;
 			std::shared_ptr<OpcUaInterface> m_opcUaWrapper;
 			std::atomic_bool m_isConnected = {false};
 			std::atomic_bool m_tryConnecting = {false};
+			/// Set by asynchronous responses, they cannot call the server themselves. Handled by the connect thread.
+			std::atomic_bool m_namespaceCacheOutdated = {false};
 
 			Subscription m_subscr;
 
-			struct UaNodeId_Compare
+			/// Supertype of each type, might be shared with the clients created after a reset
+			std::shared_ptr<SuperTypeCache> m_pSuperTypes;
+			/// Structures loaded from the server, linked into m_dataTypeArray
+			std::shared_ptr<RuntimeDataTypes> m_pRuntimeDataTypes;
+			/// Namespace index and numeric id of an encoding node
+			typedef std::pair<UA_UInt16, UA_UInt32> EncodingId_t;
+			/// Encodings whose data type was loaded successfully
+			std::set<EncodingId_t> m_loadedEncodings;
+			/// Encodings whose data type cannot be loaded, e.g. unions or types without a StructureDefinition.
+			/// Not requested again until the next connect.
+			std::set<EncodingId_t> m_unsupportedEncodings;
+			struct EncodingRetry_t
 			{
-				bool operator()(const open62541Cpp::UA_NodeId &left, const open62541Cpp::UA_NodeId &right) const
-				{
-						   return left < right;
-				}
+				std::chrono::steady_clock::time_point NextAttempt;
+				std::chrono::seconds Delay;
 			};
-
-			/// Map for chaching super types. Key = Type, Value = Supertype
-			std::map<open62541Cpp::UA_NodeId, open62541Cpp::UA_NodeId, UaNodeId_Compare> m_superTypes;
+			/// Encodings whose loading failed with a communication error, requested again with an increasing delay
+			std::map<EncodingId_t, EncodingRetry_t> m_encodingRetries;
+			/// Limits the nesting of structures loaded by loadDataType
+			static constexpr std::size_t MaxDataTypeDepth = 8;
 
         public:
 			std::shared_ptr<UA_Client> m_pClient; // Zugriff aus dem ConnectThread, dem PublisherThread
-            std::recursive_mutex m_clientMutex;
+            ClientMutex m_clientMutex;
 		private:
 			void on_connected();
 
 			std::vector<nlohmann::json> readValues2(const std::list<ModelOpcUa::NodeId_t> &modelNodeIds);
 
+			struct AsyncRequest_t
+			{
+				std::function<void(void *)> onResponse;
+				std::function<void(std::exception_ptr)> onError;
+			};
+
+			/// Send a request without waiting for the response, m_clientMutex is only held for sending. The response is processed
+			/// by the thread iterating the client (or by any synchronous service call) with the client locked. onResponse is only
+			/// called for responses with a good service result, onError for everything else, including requests that could not be
+			/// sent, timed out or were cancelled by a disconnect.
+			void sendAsyncRequest(const void *request, const UA_DataType *requestType, const UA_DataType *responseType,
+								  std::function<void(void *)> onResponse, std::function<void(std::exception_ptr)> onError);
+
+			static void asyncServiceCallback(UA_Client *client, void *userdata, UA_UInt32 requestId, void *response);
+
+			/// Split browseNames into index lists of at most m_maxNodesPerTranslateBrowsePaths entries, null browse names are
+			/// reported in translateResults and skipped
+			std::vector<std::vector<std::size_t>> translateRequestChunks(const std::vector<ModelOpcUa::QualifiedName_t> &browseNames,
+			std::vector<TranslateBrowsePathResult_t> &translateResults);
+
+			void prepareTranslateRequest(UA_TranslateBrowsePathsToNodeIdsRequest &request,
+			const open62541Cpp::UA_NodeId &startUaNodeId,
+			const std::vector<ModelOpcUa::QualifiedName_t> &browseNames,
+			const std::vector<std::size_t> &requestIndices);
+
+			/// Store the results of one TranslateBrowsePathsToNodeIds response, returns true if the server reported an unknown node
+			bool translateResponseToResults(const ModelOpcUa::NodeId_t &startNode,
+			const std::vector<ModelOpcUa::QualifiedName_t> &browseNames,
+			const std::vector<std::size_t> &requestIndices,
+			const UA_TranslateBrowsePathsToNodeIdsResponse &response,
+			std::vector<TranslateBrowsePathResult_t> &translateResults);
+
 			UA_ApplicationDescription &
 			prepareSessionConnectInfo(UA_ApplicationDescription &sessionConnectInfo);
 			void initializeNamespaceCache();
 
 			UA_BrowseDescription prepareBrowseContext(ModelOpcUa::NodeId_t referenceTypeId);
 
-			static void handleContinuationPoint(const UA_ByteString & /*continuationPoint*/);
+			void ReferenceDescriptionsToBrowseResults(const UA_ReferenceDescription *referenceDescriptions,
+			std::size_t referenceDescriptionsSize,
+			std::list<ModelOpcUa::BrowseResult_t> &browseResult,
+			std::function<bool(const UA_ReferenceDescription &)> filter = [] (const UA_ReferenceDescription&) {return true;});
 
-			void ReferenceDescriptionsToBrowseResults(const std::vector<UA_ReferenceDescription> &referenceDescriptions,
+			/// Convert the references of uaBrowseResult and fetch all further pages via BrowseNext.
+			/// Takes ownership of the continuation point of uaBrowseResult.
+			void appendBrowseResultPages(UA_BrowseResult &uaBrowseResult,
 			std::list<ModelOpcUa::BrowseResult_t> &browseResult,
 			std::function<bool(const UA_ReferenceDescription &)> filter = [] (const UA_ReferenceDescription&) {return true;});
 
@@ -62,11 +62,28 @@ namespace Umati {
 					UA_ByteString &continuationPoint,
 					std::vector<UA_ReferenceDescription> &referenceDescriptions) = 0;
 
+			virtual UA_BrowseResponse SessionBrowse(UA_Client *client,
+					const UA_BrowseRequest &browseRequest) = 0;
+
+			virtual UA_BrowseNextResponse SessionBrowseNext(UA_Client *client,
+					UA_Boolean releaseContinuationPoint,
+					const UA_ByteString &continuationPoint) = 0;
+
 			virtual UA_StatusCode SessionTranslateBrowsePathsToNodeIds(UA_Client *client,
 					UA_BrowsePath &browsePaths,
 					UA_BrowsePathResult &browsePathResults,
 					UA_DiagnosticInfo &diagnosticInfos) = 0;
 
+			virtual UA_TranslateBrowsePathsToNodeIdsResponse SessionTranslateBrowsePathsToNodeIds(UA_Client *client,
+					const UA_TranslateBrowsePathsToNodeIdsRequest &request) = 0;
+
+			virtual UA_StatusCode SessionSendAsyncRequest(UA_Client *client,
+					const void *request,
+					const UA_DataType *requestType,
+					UA_ClientAsyncServiceCallback callback,
+					const UA_DataType *responseType,
+					void *userdata) = 0;
+
 			virtual void setSubscription(Subscription *p_in_subscr) = 0;
 
 			virtual void SubscriptionCreateSubscription(UA_Client *client) = 0;
@@ -75,8 +92,17 @@ namespace Umati {
 			SubscriptionSubscribe(UA_Client *client, ModelOpcUa::NodeId_t nodeId,
 								  Dashboard::IDashboardDataClient::newValueCallbackFunction_t callback) = 0;
 
+			virtual std::vector<std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>>
+			SubscriptionSubscribeMany(UA_Client *client, const std::vector<ModelOpcUa::NodeId_t> &nodeIds,
+									  const std::vector<Dashboard::IDashboardDataClient::newValueCallbackFunction_t> &callbacks,
+									  std::size_t maxItemsPerCall, double samplingInterval_ms) = 0;
+
 			virtual void SubscriptionUnsubscribe(UA_Client *client, std::vector<int32_t> monItemIds, std::vector<int32_t> clientHandles) = 0;
 
+			virtual std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>
+			SubscriptionSubscribeModelChanges(UA_Client *client,
+									  Dashboard::IDashboardDataClient::modelChangeCallbackFunction_t callback) = 0;
+
 		protected:
 			std::vector<std::string> namespaceArray;
 			Subscription *p_subscr;
@@ -210,6 +236,23 @@ namespace Umati {
 					return browseResponse;
 			}
 
+			UA_BrowseResponse SessionBrowse(UA_Client *client,
+					const UA_BrowseRequest &browseRequest) override {
+					return UA_Client_Service_browse(client, browseRequest);
+			}
+
+			UA_BrowseNextResponse SessionBrowseNext(UA_Client *client,
+					UA_Boolean releaseContinuationPoint,
+					const UA_ByteString &continuationPoint) override {
+					UA_BrowseNextRequest browseNextRequest;
+					UA_BrowseNextRequest_init(&browseNextRequest);
+					browseNextRequest.releaseContinuationPoints = releaseContinuationPoint;
+					// The request does not own the continuation point, so it is not cleared here
+					browseNextRequest.continuationPoints = const_cast<UA_ByteString *>(&continuationPoint);
+					browseNextRequest.continuationPointsSize = 1;
+					return UA_Client_Service_browseNext(client, browseNextRequest);
+			}
+
 			UA_StatusCode SessionTranslateBrowsePathsToNodeIds(UA_Client *client,
 					UA_BrowsePath &browsePaths,
 					UA_BrowsePathResult &browsePathResults,
@@ -227,6 +270,20 @@ namespace Umati {
 				return retCode;				
 			}
 
+			UA_TranslateBrowsePathsToNodeIdsResponse SessionTranslateBrowsePathsToNodeIds(UA_Client *client,
+					const UA_TranslateBrowsePathsToNodeIdsRequest &request) override {
+				return UA_Client_Service_translateBrowsePathsToNodeIds(client, request);
+			}
+
+			UA_StatusCode SessionSendAsyncRequest(UA_Client *client,
+					const void *request,
+					const UA_DataType *requestType,
+					UA_ClientAsyncServiceCallback callback,
+					const UA_DataType *responseType,
+					void *userdata) override {
+				return UA_Client_sendAsyncRequest(client, request, requestType, callback, responseType, userdata, nullptr);
+			}
+
 			void setSubscription(Subscription *p_in_subscr) override { p_subscr = p_in_subscr; }
 
 			void SubscriptionCreateSubscription(UA_Client *client) override {
@@ -251,10 +308,27 @@ namespace Umati {
 				}
 			}
 
+			std::vector<std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>>
+			SubscriptionSubscribeMany(UA_Client *client, const std::vector<ModelOpcUa::NodeId_t> &nodeIds,
+									  const std::vector<Dashboard::IDashboardDataClient::newValueCallbackFunction_t> &callbacks,
+									  std::size_t maxItemsPerCall, double samplingInterval_ms) override {
+				if (p_subscr == nullptr) {
+					LOG(ERROR) << "Unable to subscribe, pointer is NULL ";
+					exit(SIGTERM);
+				}
+				return p_subscr->SubscribeMany(client, nodeIds, callbacks, maxItemsPerCall, samplingInterval_ms);
+			}
+
 			void SubscriptionUnsubscribe(UA_Client *client, std::vector<int32_t> monItemIds, std::vector<int32_t> clientHandles){
 				p_subscr->Unsubscribe(client, monItemIds, clientHandles);
 			}
 
+			std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>
+			SubscriptionSubscribeModelChanges(UA_Client *client,
+									  Dashboard::IDashboardDataClient::modelChangeCallbackFunction_t callback) override {
+				return p_subscr->SubscribeModelChanges(client, std::move(callback));
+			}
+
 			UA_SessionState m_pSessionState;
 			UA_SecureChannelState m_pChannelState;
 		};
@@ -0,0 +1,187 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "RuntimeDataTypes.hpp"
+
+#include <easylogging++.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace Umati
+{
+	namespace OpcUa
+	{
+		namespace
+		{
+			/// Arrays are stored as length and data pointer, optional scalars as pointer
+			const std::size_t PointerAlignment = std::max(alignof(void *), alignof(std::size_t));
+		} // namespace
+
+		RuntimeDataTypes::~RuntimeDataTypes()
+		{
+			for (auto &entry : m_entries)
+			{
+				UA_NodeId_clear(&entry.Type.typeId);
+				UA_NodeId_clear(&entry.Type.binaryEncodingId);
+			}
+		}
+
+		const UA_DataType *RuntimeDataTypes::add(const UA_NodeId &dataTypeId, const std::string &name,
+												 const UA_StructureDefinition &definition,
+												 const std::vector<const UA_DataType *> &fieldTypes,
+												 UA_DataTypeArray &customTypes)
+		{
+			UA_UInt32 typeKind;
+			switch (definition.structureType)
+			{
+			case UA_STRUCTURETYPE_STRUCTURE:
+				typeKind = UA_DATATYPEKIND_STRUCTURE;
+				break;
+			case UA_STRUCTURETYPE_STRUCTUREWITHOPTIONALFIELDS:
+				typeKind = UA_DATATYPEKIND_OPTSTRUCT;
+				break;
+			default:
+				LOG(WARNING) << "Structure " << name << " not supported, structure type " << definition.structureType;
+				return nullptr;
+			}
+			if (definition.fieldsSize > std::numeric_limits<UA_Byte>::max() || fieldTypes.size() != definition.fieldsSize)
+			{
+				LOG(WARNING) << "Structure " << name << " not supported, too many fields";
+				return nullptr;
+			}
+
+			m_entries.emplace_back();
+			Entry_t &entry = m_entries.back();
+			entry.Name = name;
+			std::size_t offset = 0;
+			std::size_t structureAlignment = 1;
+			for (std::size_t i = 0; i < definition.fieldsSize; ++i)
+			{
+				const UA_StructureField &field = definition.fields[i];
+				entry.MemberNames.emplace_back(reinterpret_cast<const char *>(field.name.data), field.name.length);
+
+				const UA_DataType *pFieldType = fieldTypes[i];
+				if (!pFieldType || (field.valueRank != UA_VALUERANK_SCALAR && field.valueRank != UA_VALUERANK_ONE_DIMENSION))
+				{
+					LOG(WARNING) << "Structure " << name << " not supported, unsupported field " << entry.MemberNames.back();
+					m_entries.pop_back();
+					return nullptr;
+				}
+
+				UA_DataTypeMember member;
+				std::memset(&member, 0, sizeof(member));
+				member.memberName = entry.MemberNames.back().c_str();
+				member.memberType = pFieldType;
+				member.isArray = field.valueRank == UA_VALUERANK_ONE_DIMENSION;
+				member.isOptional = typeKind == UA_DATATYPEKIND_OPTSTRUCT && field.isOptional;
+
+				std::size_t memberAlignment = PointerAlignment;
+				std::size_t memberSize = sizeof(void *);
+				if (member.isArray)
+				{
+					memberSize = sizeof(std::size_t) + sizeof(void *);
+				}
+				else if (!member.isOptional)
+				{
+					memberAlignment = alignment(*pFieldType);
+					memberSize = pFieldType->memSize;
+				}
+				std::size_t alignedOffset = alignTo(offset, memberAlignment);
+				member.padding = static_cast<UA_Byte>(alignedOffset - offset);
+				entry.Members.push_back(member);
+				offset = alignedOffset + memberSize;
+				structureAlignment = std::max(structureAlignment, memberAlignment);
+			}
+
+			std::size_t memSize = alignTo(offset, structureAlignment);
+			if (memSize > std::numeric_limits<UA_UInt16>::max())
+			{
+				LOG(WARNING) << "Structure " << name << " not supported, too large";
+				m_entries.pop_back();
+				return nullptr;
+			}
+
+			UA_DataType &type = entry.Type;
+			std::memset(&type, 0, sizeof(type));
+			type.typeName = entry.Name.c_str();
+			UA_NodeId_copy(&dataTypeId, &type.typeId);
+			UA_NodeId_copy(&definition.defaultEncodingId, &type.binaryEncodingId);
+			type.memSize = static_cast<UA_UInt16>(memSize);
+			type.typeKind = typeKind;
+			// Members are copied and cleared one by one
+			type.pointerFree = false;
+			type.overlayable = false;
+			type.membersSize = static_cast<UA_Byte>(entry.Members.size());
+			type.members = entry.Members.data();
+
+			entry.pArray.reset(new UA_DataTypeArray{customTypes.next, 1, &entry.Type});
+			customTypes.next = entry.pArray.get();
+			LOG(INFO) << "Added data type " << name << " with " << entry.Members.size() << " fields";
+			return &entry.Type;
+		}
+
+		const UA_DataType *RuntimeDataTypes::find(const UA_NodeId &dataTypeId) const
+		{
+			for (const auto &entry : m_entries)
+			{
+				if (UA_NodeId_equal(&entry.Type.typeId, &dataTypeId))
+				{
+					return &entry.Type;
+				}
+			}
+			return nullptr;
+		}
+
+		std::size_t RuntimeDataTypes::alignment(const UA_DataType &type)
+		{
+			switch (type.typeKind)
+			{
+			case UA_DATATYPEKIND_BOOLEAN:
+			case UA_DATATYPEKIND_SBYTE:
+			case UA_DATATYPEKIND_BYTE:
+				return alignof(UA_Byte);
+			case UA_DATATYPEKIND_INT16:
+			case UA_DATATYPEKIND_UINT16:
+				return alignof(UA_UInt16);
+			case UA_DATATYPEKIND_INT32:
+			case UA_DATATYPEKIND_UINT32:
+			case UA_DATATYPEKIND_STATUSCODE:
+			case UA_DATATYPEKIND_ENUM:
+				return alignof(UA_UInt32);
+			case UA_DATATYPEKIND_FLOAT:
+				return alignof(UA_Float);
+			case UA_DATATYPEKIND_INT64:
+			case UA_DATATYPEKIND_UINT64:
+			case UA_DATATYPEKIND_DATETIME:
+				return alignof(UA_Int64);
+			case UA_DATATYPEKIND_DOUBLE:
+				return alignof(UA_Double);
+			case UA_DATATYPEKIND_GUID:
+				return alignof(UA_Guid);
+			case UA_DATATYPEKIND_STRUCTURE:
+			case UA_DATATYPEKIND_OPTSTRUCT:
+			{
+				std::size_t result = 1;
+				for (std::size_t i = 0; i < type.membersSize; ++i)
+				{
+					const UA_DataTypeMember &member = type.members[i];
+					result = std::max(result, (member.isArray || member.isOptional) ? PointerAlignment
+																				   : alignment(*member.memberType));
+				}
+				return result;
+			}
+			default:
+				// Strings, NodeIds, Variants, ... contain pointers
+				return PointerAlignment;
+			}
+		}
+
+		std::size_t RuntimeDataTypes::alignTo(std::size_t offset, std::size_t alignment)
+		{
+			return (offset + alignment - 1) / alignment * alignment;
+		}
+	} // namespace OpcUa
+} // namespace Umati
@@ -0,0 +1,66 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <open62541/types.h>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Umati
+{
+	namespace OpcUa
+	{
+		/**
+		 * UA_DataType descriptors of structures created at runtime from their DataTypeDefinition,
+		 * so open62541 decodes structures without generated code (see Converter/CustomDataTypes).
+		 * The member layout follows the C struct layout that the generator would create.
+		 * Descriptors are never removed, their addresses stay valid for the lifetime of the object.
+		 */
+		class RuntimeDataTypes
+		{
+		public:
+			RuntimeDataTypes() = default;
+			RuntimeDataTypes(const RuntimeDataTypes &) = delete;
+			RuntimeDataTypes &operator=(const RuntimeDataTypes &) = delete;
+			~RuntimeDataTypes();
+
+			/// Creates the descriptor of a structure and links it into customTypes after its first array.
+			/// fieldTypes holds the descriptor of each field of definition, nullptr if it is not supported.
+			/// Decoding with customTypes must be locked by the caller.
+			/// \return nullptr for unions and structures with unsupported fields
+			const UA_DataType *add(const UA_NodeId &dataTypeId, const std::string &name,
+								   const UA_StructureDefinition &definition,
+								   const std::vector<const UA_DataType *> &fieldTypes, UA_DataTypeArray &customTypes);
+
+			/// \return nullptr if no structure with this id was added
+			const UA_DataType *find(const UA_NodeId &dataTypeId) const;
+
+			std::size_t size() const { return m_entries.size(); }
+
+		protected:
+			struct Entry_t
+			{
+				std::string Name;
+				std::deque<std::string> MemberNames;
+				std::vector<UA_DataTypeMember> Members;
+				UA_DataType Type;
+				/// Created once the type is complete, UA_DataTypeArray has const members
+				std::unique_ptr<UA_DataTypeArray> pArray;
+			};
+
+			/// Alignment of a value of type inside a structure
+			static std::size_t alignment(const UA_DataType &type);
+
+			static std::size_t alignTo(std::size_t offset, std::size_t alignment);
+
+			/// A deque keeps the descriptors at their address while it grows
+			std::deque<Entry_t> m_entries;
+		};
+	} // namespace OpcUa
+} // namespace Umati
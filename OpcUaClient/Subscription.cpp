@@ -9,9 +9,11 @@
 
 #include "Subscription.hpp"
 
+#include <algorithm>
 #include <utility>
 #include "Converter/ModelNodeIdToUaNodeId.hpp"
 #include "Converter/UaDataValueToJsonValue.hpp"
+#include "Converter/UaNodeIdToModelNodeId.hpp"
 #include "Exceptions/OpcUaNonGoodStatusCodeException.hpp"
 
 static void createDataChangeCallback(UA_Client *client, UA_UInt32 subId, void *subContext,
@@ -32,6 +34,37 @@ static void createDataChangeCallback(UA_Client *client, UA_UInt32 subId, void *s
 
 } 
 
+static void modelChangeEventCallback(UA_Client *client, UA_UInt32 subId, void *subContext,
+						UA_UInt32 monId, void *monContext, size_t nEventFields, UA_Variant *eventFields)
+{
+  auto* sub = (Umati::OpcUa::Subscription*)monContext;
+  sub->modelChangeEvent(nEventFields, eventFields);
+}
+
+/// Selects the property browseName of events of the given type
+static UA_SimpleAttributeOperand eventFieldOperand(UA_UInt32 eventTypeId, const char *browseName)
+{
+  UA_SimpleAttributeOperand operand;
+  UA_SimpleAttributeOperand_init(&operand);
+  operand.typeDefinitionId = UA_NODEID_NUMERIC(0, eventTypeId);
+  operand.browsePathSize = 1;
+  operand.browsePath = (UA_QualifiedName *) UA_Array_new(1, &UA_TYPES[UA_TYPES_QUALIFIEDNAME]);
+  operand.browsePath[0] = UA_QUALIFIEDNAME_ALLOC(0, browseName);
+  operand.attributeId = UA_ATTRIBUTEID_VALUE;
+  return operand;
+}
+
+static void setOfTypeFilterElement(UA_ContentFilterElement &element, UA_UInt32 eventTypeId)
+{
+  element.filterOperator = UA_FILTEROPERATOR_OFTYPE;
+  element.filterOperandsSize = 1;
+  element.filterOperands = (UA_ExtensionObject *) UA_Array_new(1, &UA_TYPES[UA_TYPES_EXTENSIONOBJECT]);
+  auto *literal = UA_LiteralOperand_new();
+  UA_NodeId eventType = UA_NODEID_NUMERIC(0, eventTypeId);
+  UA_Variant_setScalarCopy(&literal->value, &eventType, &UA_TYPES[UA_TYPES_NODEID]);
+  UA_ExtensionObject_setValue(&element.filterOperands[0], literal, &UA_TYPES[UA_TYPES_LITERALOPERAND]);
+}
+
 namespace Umati {
 	namespace OpcUa {
 
@@ -42,11 +75,8 @@ namespace Umati {
 			m_pSubscriptionWrapper = NULL;
 		}
 
-		Subscription::Subscription(
-				const std::map<std::string, uint16_t> &uriToIndexCache,
-				const std::map<uint16_t, std::string> &indexToUriCache
-		)
-				: m_uriToIndexCache(uriToIndexCache), m_indexToUriCache(indexToUriCache) {
+		Subscription::Subscription(const NamespaceCache &namespaceCache)
+				: m_namespaceCache(namespaceCache) {
 			LOG(WARNING) << "Created subscription " << this;
 		}
 
@@ -110,6 +140,10 @@ namespace Umati {
 			{
 				std::unique_lock<decltype(m_callbacks_mutex)> ul(m_callbacks_mutex);
 				for(UA_Int32 handle : clientHandles){
+					if (m_modelChangeCallback && (UA_UInt32)handle == m_modelChangeClientHandle) {
+						m_modelChangeCallback = nullptr;
+						continue;
+					}
 					auto it = m_callbacks.find(handle);
 					if (it != m_callbacks.end()) {
 						m_callbacks.erase(handle);
@@ -123,7 +157,7 @@ namespace Umati {
 			UA_UInt32 *newMonitoredItemIds = (UA_UInt32 *) UA_Array_new(monItemIdsSize, &UA_TYPES[UA_TYPES_UINT32]);
 			
 			for (int i = 0; i < monItemIdsSize; i++){
-				newMonitoredItemIds[i] = (UA_UInt32)clientHandles.at(i);
+				newMonitoredItemIds[i] = (UA_UInt32)monItemIds.at(i);
 			}
 
 			UA_DeleteMonitoredItemsRequest deleteRequest;
@@ -148,6 +182,130 @@ namespace Umati {
 
         }
 
+		std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle> Subscription::SubscribeModelChanges(
+				UA_Client *client,
+				Dashboard::IDashboardDataClient::modelChangeCallbackFunction_t callback
+		) {
+			{
+				std::unique_lock<decltype(m_callbacks_mutex)> ul(m_callbacks_mutex);
+				m_modelChangeCallback = std::move(callback);
+			}
+
+			// Select EventType and the Changes of both event types, only events of these types are reported
+			auto *filter = UA_EventFilter_new();
+			filter->selectClausesSize = 3;
+			filter->selectClauses = (UA_SimpleAttributeOperand *) UA_Array_new(3, &UA_TYPES[UA_TYPES_SIMPLEATTRIBUTEOPERAND]);
+			filter->selectClauses[0] = eventFieldOperand(UA_NS0ID_BASEEVENTTYPE, "EventType");
+			filter->selectClauses[1] = eventFieldOperand(UA_NS0ID_GENERALMODELCHANGEEVENTTYPE, "Changes");
+			filter->selectClauses[2] = eventFieldOperand(UA_NS0ID_SEMANTICCHANGEEVENTTYPE, "Changes");
+
+			filter->whereClause.elementsSize = 3;
+			filter->whereClause.elements = (UA_ContentFilterElement *) UA_Array_new(3, &UA_TYPES[UA_TYPES_CONTENTFILTERELEMENT]);
+			auto &orElement = filter->whereClause.elements[0];
+			orElement.filterOperator = UA_FILTEROPERATOR_OR;
+			orElement.filterOperandsSize = 2;
+			orElement.filterOperands = (UA_ExtensionObject *) UA_Array_new(2, &UA_TYPES[UA_TYPES_EXTENSIONOBJECT]);
+			for (UA_UInt32 i = 0; i < 2; ++i) {
+				auto *elementOperand = UA_ElementOperand_new();
+				elementOperand->index = i + 1;
+				UA_ExtensionObject_setValue(&orElement.filterOperands[i], elementOperand, &UA_TYPES[UA_TYPES_ELEMENTOPERAND]);
+			}
+			setOfTypeFilterElement(filter->whereClause.elements[1], UA_NS0ID_GENERALMODELCHANGEEVENTTYPE);
+			setOfTypeFilterElement(filter->whereClause.elements[2], UA_NS0ID_SEMANTICCHANGEEVENTTYPE);
+
+			UA_MonitoredItemCreateRequest monItemCreateReq;
+			UA_MonitoredItemCreateRequest_init(&monItemCreateReq);
+			monItemCreateReq.itemToMonitor.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER);
+			monItemCreateReq.itemToMonitor.attributeId = UA_ATTRIBUTEID_EVENTNOTIFIER;
+			monItemCreateReq.monitoringMode = UA_MONITORINGMODE_REPORTING;
+			UA_UInt32 clientHandle = nextId++;
+			monItemCreateReq.requestedParameters.clientHandle = clientHandle;
+			monItemCreateReq.requestedParameters.samplingInterval = 0;
+			// Several changes might be reported at once, e.g. while a machine is added
+			monItemCreateReq.requestedParameters.queueSize = 100;
+			monItemCreateReq.requestedParameters.discardOldest = UA_TRUE;
+			UA_ExtensionObject_setValue(&monItemCreateReq.requestedParameters.filter, filter, &UA_TYPES[UA_TYPES_EVENTFILTER]);
+
+			auto monItemCreateResult = UA_Client_MonitoredItems_createEvent(client, m_pSubscriptionID, UA_TIMESTAMPSTORETURN_NEITHER,
+																			monItemCreateReq, this, modelChangeEventCallback, nullptr);
+			UA_MonitoredItemCreateRequest_clear(&monItemCreateReq);
+
+			auto statusCode = monItemCreateResult.statusCode;
+			auto monitoredItemId = monItemCreateResult.monitoredItemId;
+			bool filterRejected = false;
+			if (!UA_StatusCode_isBad(statusCode) &&
+				monItemCreateResult.filterResult.encoding == UA_EXTENSIONOBJECT_DECODED &&
+				monItemCreateResult.filterResult.content.decoded.type == &UA_TYPES[UA_TYPES_EVENTFILTERRESULT]) {
+				auto *filterResult = (UA_EventFilterResult *) monItemCreateResult.filterResult.content.decoded.data;
+				for (std::size_t i = 0; i < filterResult->selectClauseResultsSize; ++i) {
+					filterRejected |= UA_StatusCode_isBad(filterResult->selectClauseResults[i]);
+				}
+			}
+			UA_MonitoredItemCreateResult_clear(&monItemCreateResult);
+
+			if (UA_StatusCode_isBad(statusCode)) {
+				LOG(WARNING) << "Subscribing to model change events failed with: " << UA_StatusCode_name(statusCode);
+				std::unique_lock<decltype(m_callbacks_mutex)> ul(m_callbacks_mutex);
+				m_modelChangeCallback = nullptr;
+				throw Exceptions::OpcUaNonGoodStatusCodeException(statusCode);
+			}
+			{
+				std::unique_lock<decltype(m_callbacks_mutex)> ul(m_callbacks_mutex);
+				m_modelChangeClientHandle = clientHandle;
+			}
+			auto handle = std::make_shared<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>(
+					clientHandle, monitoredItemId, Dashboard::NodeId_Server);
+			if (filterRejected) {
+				LOG(WARNING) << "Server does not support the event filter for model change events";
+				Unsubscribe(client, {handle->getMonitoredItemId()}, {handle->getClientHandle()});
+				throw Exceptions::UmatiException("Model change event filter not supported.");
+			}
+			return handle;
+		}
+
+		void Subscription::modelChangeEvent(std::size_t nEventFields, const UA_Variant *eventFields) {
+			std::vector<Dashboard::IDashboardDataClient::ModelChange_t> changes;
+			// Field 1: Changes of GeneralModelChangeEvents, Field 2: Changes of SemanticChangeEvents
+			for (std::size_t iField = 1; iField < nEventFields && iField < 3; ++iField) {
+				const auto &field = eventFields[iField];
+				if (UA_Variant_isEmpty(&field)) {
+					continue;
+				}
+				const bool isModelChange = field.type == &UA_TYPES[UA_TYPES_MODELCHANGESTRUCTUREDATATYPE];
+				if (!isModelChange && field.type != &UA_TYPES[UA_TYPES_SEMANTICCHANGESTRUCTUREDATATYPE]) {
+					LOG(INFO) << "Unexpected type of model changes, handling them as unknown changes";
+					changes.clear();
+					break;
+				}
+				std::size_t nChanges = UA_Variant_isScalar(&field) ? 1 : field.arrayLength;
+				for (std::size_t i = 0; i < nChanges; ++i) {
+					const UA_NodeId *affected;
+					const UA_NodeId *affectedType;
+					if (isModelChange) {
+						const auto &change = ((const UA_ModelChangeStructureDataType *) field.data)[i];
+						affected = &change.affected;
+						affectedType = &change.affectedType;
+					} else {
+						const auto &change = ((const UA_SemanticChangeStructureDataType *) field.data)[i];
+						affected = &change.affected;
+						affectedType = &change.affectedType;
+					}
+					open62541Cpp::UA_NodeId affectedTmp;
+					UA_NodeId_copy(affected, affectedTmp.NodeId);
+					open62541Cpp::UA_NodeId affectedTypeTmp;
+					UA_NodeId_copy(affectedType, affectedTypeTmp.NodeId);
+					auto affectedNodeId = Converter::UaNodeIdToModelNodeId(affectedTmp, m_namespaceCache.indexToUri()).getNodeId();
+					auto affectedTypeNodeId = Converter::UaNodeIdToModelNodeId(affectedTypeTmp, m_namespaceCache.indexToUri()).getNodeId();
+					changes.push_back({affectedNodeId, affectedTypeNodeId});
+				}
+			}
+
+			std::unique_lock<decltype(m_callbacks_mutex)> ul(m_callbacks_mutex);
+			if (m_modelChangeCallback) {
+				m_modelChangeCallback(changes);
+			}
+		}
+
 		std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle> Subscription::Subscribe(
 				UA_Client *client,
 				ModelOpcUa::NodeId_t nodeId,
@@ -168,8 +326,8 @@ namespace Umati {
 					std::unique_lock<decltype(m_callbacks_mutex)> ul(m_callbacks_mutex);
 					m_callbacks.insert(std::make_pair(monItemCreateReq.requestedParameters.clientHandle, callback));
 				}
-                auto returnPointer = std::make_shared<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>(monItemCreateResult.monitoredItemId,
-																 monItemCreateReq.requestedParameters.clientHandle, nodeId);
+                auto returnPointer = std::make_shared<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>(monItemCreateReq.requestedParameters.clientHandle,
+																 monItemCreateResult.monitoredItemId, nodeId);
 				UA_MonitoredItemCreateResult_clear(&monItemCreateResult);
 				UA_MonitoredItemCreateRequest_clear(&monItemCreateReq);
 
@@ -183,16 +341,99 @@ namespace Umati {
 			}
 		}
 		
+		std::vector<std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>> Subscription::SubscribeMany(
+				UA_Client *client,
+				const std::vector<ModelOpcUa::NodeId_t> &nodeIds,
+				const std::vector<Dashboard::IDashboardDataClient::newValueCallbackFunction_t> &callbacks,
+				std::size_t maxItemsPerCall,
+				double samplingInterval_ms
+		) {
+			std::vector<std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>> ret(nodeIds.size());
+			if (callbacks.size() != nodeIds.size()) {
+				throw Exceptions::UmatiException("Number of callbacks does not match number of nodes.");
+			}
+			if (maxItemsPerCall == 0) {
+				maxItemsPerCall = nodeIds.size();
+			}
+
+			for (std::size_t chunkBegin = 0; chunkBegin < nodeIds.size(); chunkBegin += maxItemsPerCall) {
+				const std::size_t chunkSize = std::min(maxItemsPerCall, nodeIds.size() - chunkBegin);
+
+				UA_CreateMonitoredItemsRequest request;
+				UA_CreateMonitoredItemsRequest_init(&request);
+				request.subscriptionId = m_pSubscriptionID;
+				request.timestampsToReturn = UA_TIMESTAMPSTORETURN_SOURCE;
+				request.itemsToCreate = (UA_MonitoredItemCreateRequest *) UA_Array_new(chunkSize,
+																					   &UA_TYPES[UA_TYPES_MONITOREDITEMCREATEREQUEST]);
+				request.itemsToCreateSize = chunkSize;
+
+				std::vector<void *> contexts(chunkSize);
+				std::vector<UA_Client_DataChangeNotificationCallback> notificationCallbacks(chunkSize, createDataChangeCallback);
+				std::vector<UA_Client_DeleteMonitoredItemCallback> deleteCallbacks(chunkSize, nullptr);
+
+				// Register the callbacks before the request is sent, the first notification may be
+				// processed while the client is still waiting for the CreateMonitoredItems response.
+				{
+					std::unique_lock<decltype(m_callbacks_mutex)> ul(m_callbacks_mutex);
+					for (std::size_t i = 0; i < chunkSize; ++i) {
+						prepareMonItemCreateReq(nodeIds[chunkBegin + i], request.itemsToCreate[i], samplingInterval_ms);
+						auto clientHandle = request.itemsToCreate[i].requestedParameters.clientHandle;
+						contexts[i] = (void *) ((UA_Int64) clientHandle);
+						m_callbacks.insert(std::make_pair(clientHandle, callbacks[chunkBegin + i]));
+					}
+				}
+
+				auto response = UA_Client_MonitoredItems_createDataChanges(client, request, contexts.data(),
+																		   notificationCallbacks.data(),
+																		   deleteCallbacks.data());
+
+				const bool serviceFailed = UA_StatusCode_isBad(response.responseHeader.serviceResult) ||
+										   response.resultsSize != chunkSize;
+				if (serviceFailed) {
+					LOG(ERROR) << "Create Monitored items for " << chunkSize << " nodes failed with: "
+							   << UA_StatusCode_name(response.responseHeader.serviceResult);
+				}
+
+				{
+					std::unique_lock<decltype(m_callbacks_mutex)> ul(m_callbacks_mutex);
+					for (std::size_t i = 0; i < chunkSize; ++i) {
+						const auto &nodeId = nodeIds[chunkBegin + i];
+						auto clientHandle = request.itemsToCreate[i].requestedParameters.clientHandle;
+						if (serviceFailed || UA_StatusCode_isBad(response.results[i].statusCode)) {
+							if (!serviceFailed) {
+								LOG(ERROR) << "Create Monitored items for " << nodeId << " failed with: "
+										   << UA_StatusCode_name(response.results[i].statusCode);
+							}
+							m_callbacks.erase(clientHandle);
+							continue;
+						}
+						if (response.results[i].revisedQueueSize != 1) {
+							LOG(WARNING) << "Expect revisedQueueSize == 1 for " << nodeId
+										 << " , got:" << response.results[i].revisedQueueSize;
+						}
+						ret[chunkBegin + i] = std::make_shared<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>(
+								clientHandle, response.results[i].monitoredItemId, nodeId);
+					}
+				}
+
+				UA_CreateMonitoredItemsResponse_clear(&response);
+				UA_CreateMonitoredItemsRequest_clear(&request);
+			}
+
+			return ret;
+		}
+
 		UA_MonitoredItemCreateRequest &Subscription::prepareMonItemCreateReq(const ModelOpcUa::NodeId_t &nodeId,
-																			 UA_MonitoredItemCreateRequest &monItemCreateReq) const {
+																			 UA_MonitoredItemCreateRequest &monItemCreateReq,
+																			 double samplingInterval_ms) const {
 			UA_MonitoredItemCreateRequest_init(&monItemCreateReq);
 			monItemCreateReq.itemToMonitor.attributeId = UA_ATTRIBUTEID_VALUE;
 			monItemCreateReq.monitoringMode = UA_MONITORINGMODE_REPORTING;
 			monItemCreateReq.requestedParameters.clientHandle = nextId++;
-			monItemCreateReq.requestedParameters.samplingInterval = 300;
+			monItemCreateReq.requestedParameters.samplingInterval = samplingInterval_ms;
 			monItemCreateReq.requestedParameters.queueSize = 1;
 			monItemCreateReq.requestedParameters.discardOldest = UA_TRUE;
-			open62541Cpp::UA_NodeId id = (open62541Cpp::UA_NodeId)(Converter::ModelNodeIdToUaNodeId(nodeId, m_uriToIndexCache)
+			open62541Cpp::UA_NodeId id = (open62541Cpp::UA_NodeId)(Converter::ModelNodeIdToUaNodeId(nodeId, m_namespaceCache.uriToIndex())
 					.getNodeId());
 			UA_NodeId_copy(id.NodeId,&monItemCreateReq.itemToMonitor.nodeId);
 			
@@ -18,6 +18,7 @@
 #include <atomic>
 #include <IDashboardDataClient.hpp>
 #include "OpcUaSubscriptionInterface.hpp"
+#include "NamespaceCache.hpp"
 #include <mutex>
 
 namespace Umati {
@@ -27,8 +28,7 @@ namespace Umati {
 
 			~Subscription();
 
-			Subscription(const std::map<std::string, uint16_t> &m_uriToIndexCache,
-						 const std::map<uint16_t, std::string> &m_indexToUriCache);
+			explicit Subscription(const NamespaceCache &namespaceCache);
 
 			void subscriptionStatusChanged(UA_Client *client,UA_Int32 clientSubscriptionHandle, const UA_StatusCode &status);
 
@@ -40,8 +40,23 @@ namespace Umati {
 			virtual std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>
 			Subscribe(UA_Client *client, ModelOpcUa::NodeId_t, Dashboard::IDashboardDataClient::newValueCallbackFunction_t callback);
 
+			/// Creates monitored items for all nodeIds, using one CreateMonitoredItems call per maxItemsPerCall nodes.
+			/// Returns one handle per node, nullptr for nodes that could not be monitored.
+			std::vector<std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>>
+			SubscribeMany(UA_Client *client, const std::vector<ModelOpcUa::NodeId_t> &nodeIds,
+						  const std::vector<Dashboard::IDashboardDataClient::newValueCallbackFunction_t> &callbacks,
+						  std::size_t maxItemsPerCall,
+						  double samplingInterval_ms = Dashboard::IDashboardDataClient::DefaultSamplingInterval_ms);
+
 			void Unsubscribe(UA_Client *client, std::vector<int32_t> monItemIds, std::vector<int32_t> clientHandles);
 
+			/// Creates an event monitored item on the Server object for GeneralModelChangeEvents and SemanticChangeEvents.
+			/// Throws if the server rejects the monitored item or its event filter.
+			std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>
+			SubscribeModelChanges(UA_Client *client, Dashboard::IDashboardDataClient::modelChangeCallbackFunction_t callback);
+
+			void modelChangeEvent(std::size_t nEventFields, const UA_Variant *eventFields);
+
 			void createSubscription(UA_Client *client);
 
 			void deleteSubscription(UA_Client *client);
@@ -53,18 +68,21 @@ namespace Umati {
 
 			friend class ValueSubscriptionHandle;
 
-			const std::map<std::string, uint16_t> &m_uriToIndexCache;
-			const std::map<uint16_t, std::string> &m_indexToUriCache;
+			const NamespaceCache &m_namespaceCache;
 			static std::atomic_uint nextId;
 			UA_Int32 m_pSubscriptionID;
 			Umati::OpcUa::OpcUaSubscriptionInterface *m_pSubscriptionWrapper = new OpcUaSubscriptionWrapper();
 
 			std::mutex m_callbacks_mutex;
 			std::map<UA_Int32, Dashboard::IDashboardDataClient::newValueCallbackFunction_t> m_callbacks;
+			Dashboard::IDashboardDataClient::modelChangeCallbackFunction_t m_modelChangeCallback;
+			/// Client handle of the model change event monitored item, identifies it in Unsubscribe
+			UA_UInt32 m_modelChangeClientHandle = 0;
 
 			UA_MonitoredItemCreateRequest &
 			prepareMonItemCreateReq(const ModelOpcUa::NodeId_t &nodeId,
-									UA_MonitoredItemCreateRequest &monItemCreateReq) const;
+									UA_MonitoredItemCreateRequest &monItemCreateReq,
+									double samplingInterval_ms = Dashboard::IDashboardDataClient::DefaultSamplingInterval_ms) const;
 
 			static void
 			validateMonitorItemResult(const UA_StatusCode &uaResult, UA_MonitoredItemCreateResult monItemCreateResult,
@@ -0,0 +1,65 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "SuperTypeCache.hpp"
+
+#include <algorithm>
+
+namespace Umati
+{
+	namespace OpcUa
+	{
+		SuperTypeCache::SuperTypeCache(std::size_t capacity)
+			: m_capacity(std::max<std::size_t>(capacity, 1))
+		{
+		}
+
+		bool SuperTypeCache::get(const ModelOpcUa::NodeId_t &type, ModelOpcUa::NodeId_t &superType)
+		{
+			std::lock_guard<decltype(m_mutex)> l(m_mutex);
+			auto it = m_index.find(type);
+			if (it == m_index.end())
+			{
+				return false;
+			}
+			m_entries.splice(m_entries.begin(), m_entries, it->second);
+			superType = it->second->second;
+			return true;
+		}
+
+		void SuperTypeCache::put(const ModelOpcUa::NodeId_t &type, const ModelOpcUa::NodeId_t &superType)
+		{
+			std::lock_guard<decltype(m_mutex)> l(m_mutex);
+			auto it = m_index.find(type);
+			if (it != m_index.end())
+			{
+				it->second->second = superType;
+				m_entries.splice(m_entries.begin(), m_entries, it->second);
+				return;
+			}
+
+			m_entries.emplace_front(type, superType);
+			m_index.emplace(type, m_entries.begin());
+			if (m_entries.size() > m_capacity)
+			{
+				m_index.erase(m_entries.back().first);
+				m_entries.pop_back();
+			}
+		}
+
+		std::size_t SuperTypeCache::size()
+		{
+			std::lock_guard<decltype(m_mutex)> l(m_mutex);
+			return m_entries.size();
+		}
+
+		void SuperTypeCache::clear()
+		{
+			std::lock_guard<decltype(m_mutex)> l(m_mutex);
+			m_index.clear();
+			m_entries.clear();
+		}
+	} // namespace OpcUa
+} // namespace Umati
@@ -0,0 +1,50 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include "ModelOpcUa/ModelDefinition.hpp"
+
+namespace Umati
+{
+	namespace OpcUa
+	{
+		/**
+		 * Thread safe cache of the supertype of each type, the least recently used entries are evicted beyond capacity.
+		 * Types are identified by namespace URI, so the cache stays valid when the client reconnects and can be
+		 * shared by all clients created after a reset.
+		 */
+		class SuperTypeCache
+		{
+		public:
+			explicit SuperTypeCache(std::size_t capacity = 10000);
+
+			/// \return false if the type is unknown. A null superType means that the type has no supertype.
+			bool get(const ModelOpcUa::NodeId_t &type, ModelOpcUa::NodeId_t &superType);
+
+			void put(const ModelOpcUa::NodeId_t &type, const ModelOpcUa::NodeId_t &superType);
+
+			std::size_t size();
+
+			std::size_t capacity() const { return m_capacity; }
+
+			void clear();
+
+		protected:
+			typedef std::list<std::pair<ModelOpcUa::NodeId_t, ModelOpcUa::NodeId_t>> Entries_t;
+
+			std::mutex m_mutex;
+			const std::size_t m_capacity;
+			/// Most recently used entry first
+			Entries_t m_entries;
+			std::unordered_map<ModelOpcUa::NodeId_t, Entries_t::iterator> m_index;
+		};
+	} // namespace OpcUa
+} // namespace Umati
@@ -0,0 +1,79 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// Compares lookups in the std::map keyed by NodeId_t that the type map used before with NodeIdMap_t,
+// searched with NodeId_t and with already interned ids, on one and on several threads.
+// Not registered with add_test, run the executable manually.
+
+#include <ModelOpcUa/InternedNodeId.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	const std::size_t Iterations = 2000000;
+	const std::size_t NumIds = 5000;
+
+	/// Runs lookup(i) Iterations times on each of numThreads threads
+	template<typename Lookup>
+	void run(const char *name, std::size_t numThreads, Lookup lookup) {
+		std::atomic<std::size_t> found = {0};
+		auto start = std::chrono::steady_clock::now();
+		std::vector<std::thread> threads;
+		for (std::size_t t = 0; t < numThreads; ++t) {
+			threads.emplace_back([&found, &lookup, t]() {
+				std::size_t threadFound = 0;
+				for (std::size_t i = 0; i < Iterations; ++i) {
+					threadFound += lookup((i * 7919 + t) % NumIds);
+				}
+				found += threadFound;
+			});
+		}
+		for (auto &thread : threads) {
+			thread.join();
+		}
+		auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+		// found keeps the lookups from being optimized away
+		std::cout << name << ", " << numThreads << " threads: " << duration.count() / Iterations << " ns/lookup ("
+				  << found << " found)" << std::endl;
+	}
+}
+
+int main() {
+	std::vector<ModelOpcUa::NodeId_t> nodeIds;
+	for (std::size_t i = 0; i < NumIds; ++i) {
+		// Ids of a few companion specifications, as in a type map
+		nodeIds.push_back(ModelOpcUa::NodeId_t{"http://opcfoundation.org/UA/Machinery/" + std::to_string(i % 4) + "/",
+											   "i=" + std::to_string(1000 + i)});
+	}
+	std::vector<ModelOpcUa::InternedNodeId_t> internedIds(nodeIds.begin(), nodeIds.end());
+
+	std::map<ModelOpcUa::NodeId_t, std::size_t> orderedMap;
+	ModelOpcUa::NodeIdMap_t<std::size_t> hashMap;
+	for (std::size_t i = 0; i < NumIds; ++i) {
+		orderedMap.emplace(nodeIds[i], i);
+		hashMap.emplace(internedIds[i], i);
+	}
+
+	auto hardwareThreads = std::max(2u, std::thread::hardware_concurrency());
+	for (std::size_t numThreads : {std::size_t(1), static_cast<std::size_t>(hardwareThreads)}) {
+		run("std::map, NodeId_t", numThreads, [&](std::size_t i) {
+			return orderedMap.count(nodeIds[i]);
+		});
+		run("NodeIdMap_t, NodeId_t", numThreads, [&](std::size_t i) {
+			return hashMap.count(nodeIds[i]);
+		});
+		run("NodeIdMap_t, interned", numThreads, [&](std::size_t i) {
+			return hashMap.count(internedIds[i]);
+		});
+	}
+	return 0;
+}
@@ -0,0 +1,83 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// Compares the element by element conversion of arrays that UaDataValueToJsonValue used before
+// with UaNumericArray. Not registered with add_test, run the executable manually.
+
+#include <Converter/UaNumericArray.hpp>
+#include <open62541/types.h>
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+namespace {
+	const std::size_t Iterations = 200;
+
+	/// Same steps as the former per element path: a scalar variant and a json value for each element
+	template<typename T>
+	nlohmann::json elementWise(const UA_Variant &variant) {
+		nlohmann::json result;
+		const T *data = static_cast<const T *>(variant.data);
+		for (std::size_t i = 0; i < variant.arrayLength; ++i) {
+			UA_Variant element;
+			UA_Variant_setScalar(&element, const_cast<T *>(data + i), variant.type);
+			nlohmann::json jsonValue;
+			jsonValue = *static_cast<T *>(element.data);
+			result.push_back(jsonValue);
+		}
+		return result;
+	}
+
+	template<typename Convert>
+	void run(const char *name, const UA_Variant &variant, Convert convert) {
+		std::size_t totalSize = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (std::size_t i = 0; i < Iterations; ++i) {
+			totalSize += convert(variant).size();
+		}
+		auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+		// totalSize keeps the calls from being optimized away
+		std::cout << name << ": " << duration.count() / (Iterations * variant.arrayLength) << " ns/element ("
+				  << totalSize << " values)" << std::endl;
+	}
+
+	nlohmann::json bulk(const UA_Variant &variant) {
+		nlohmann::json result;
+		Umati::OpcUa::Converter::UaNumericArray::toJson(variant, result);
+		return result;
+	}
+}
+
+int main() {
+	std::vector<UA_Double> curve;
+	std::vector<UA_Int32> counters;
+	for (std::size_t i = 0; i < 20000; ++i) {
+		curve.push_back(std::sin(static_cast<double>(i) / 100.0) * 42.5);
+		counters.push_back(static_cast<UA_Int32>(i * 7919));
+	}
+
+	UA_Variant doubles;
+	UA_Variant_setArray(&doubles, curve.data(), curve.size(), &UA_TYPES[UA_TYPES_DOUBLE]);
+	UA_Variant int32s;
+	UA_Variant_setArray(&int32s, counters.data(), counters.size(), &UA_TYPES[UA_TYPES_INT32]);
+
+	run("Double element wise", doubles, elementWise<UA_Double>);
+	run("Double UaNumericArray", doubles, bulk);
+	run("Int32 element wise", int32s, elementWise<UA_Int32>);
+	run("Int32 UaNumericArray", int32s, bulk);
+
+	// 200 x 100 matrix, converted to nested arrays
+	UA_UInt32 dimensions[] = {200, 100};
+	doubles.arrayDimensions = dimensions;
+	doubles.arrayDimensionsSize = 2;
+	auto matrix = bulk(doubles);
+	std::cout << "Matrix: " << matrix.size() << " x " << matrix.front().size() << ", [1][0] = " << matrix[1][0]
+			  << std::endl;
+	return 0;
+}
@@ -0,0 +1,71 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// Compares the stream based DateTime and Guid formatting that UaDataValueToJsonValue used before
+// with UaValueFormat. Not registered with add_test, run the executable manually.
+
+#include <Converter/UaValueFormat.hpp>
+#include <open62541/types.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+	const std::size_t Iterations = 1000000;
+
+	std::string streamDateTime(UA_DateTime dateTime) {
+		auto dtStruct = UA_DateTime_toStruct(dateTime);
+		std::stringstream dateTimeString;
+		dateTimeString << dtStruct.year << "-" << dtStruct.month << "-" << dtStruct.day << "T"
+					   << dtStruct.hour << ":" << dtStruct.min << ":" << dtStruct.sec << ":" << dtStruct.milliSec << "Z";
+		return dateTimeString.str();
+	}
+
+	std::string streamGuid(const UA_Guid &guid) {
+		std::stringstream str;
+		str << std::hex << (uint32_t) guid.data1
+			<< '-' << (uint16_t) guid.data2
+			<< '-' << (uint16_t) guid.data3
+			<< '-' << *(uint32_t *) &guid.data4[0]
+			<< '-' << *(uint32_t *) &guid.data4[4];
+		return str.str();
+	}
+
+	template<typename T, typename Format>
+	void run(const char *name, const std::vector<T> &values, Format format) {
+		std::size_t totalLength = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (std::size_t i = 0; i < Iterations; ++i) {
+			totalLength += format(values[i % values.size()]).size();
+		}
+		auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+		// totalLength keeps the calls from being optimized away
+		std::cout << name << ": " << duration.count() / Iterations << " ns/value (" << totalLength << " chars)"
+				  << std::endl;
+	}
+}
+
+int main() {
+	std::vector<UA_DateTime> dateTimes;
+	std::vector<UA_Guid> guids;
+	UA_DateTime now = UA_DateTime_now();
+	for (std::size_t i = 0; i < 1024; ++i) {
+		dateTimes.push_back(now + static_cast<UA_DateTime>(i) * 7919 * UA_DATETIME_MSEC);
+		guids.push_back(UA_Guid_random());
+	}
+
+	run("DateTime stringstream", dateTimes, streamDateTime);
+	run("DateTime UaValueFormat", dateTimes, Umati::OpcUa::Converter::UaValueFormat::dateTimeToString);
+	run("Guid stringstream", guids, streamGuid);
+	run("Guid UaValueFormat", guids, Umati::OpcUa::Converter::UaValueFormat::guidToString);
+
+	std::cout << "Example: " << Umati::OpcUa::Converter::UaValueFormat::dateTimeToString(now) << " "
+			  << Umati::OpcUa::Converter::UaValueFormat::guidToString(guids.front()) << std::endl;
+	return 0;
+}
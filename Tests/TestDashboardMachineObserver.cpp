@@ -0,0 +1,189 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <gtest/gtest.h>
+
+#include <DashboardMachineObserver.hpp>
+#include <Exceptions/UmatiException.hpp>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+	const std::string TestUri = "http://example.com/machines/";
+
+	ModelOpcUa::NodeId_t nodeId(const std::string &id) { return ModelOpcUa::NodeId_t{TestUri, id}; }
+
+	/// Answers reads like OpcUaClient: the read fails if the first node is not readable,
+	/// other unreadable nodes are reported as null values
+	class FakeDataClient : public Umati::Dashboard::IDashboardDataClient {
+	public:
+		std::map<ModelOpcUa::NodeId_t, nlohmann::json> Values;
+		std::set<ModelOpcUa::NodeId_t> Unreadable;
+		std::size_t NumReads = 0;
+
+		std::vector<nlohmann::json> ReadeNodeValues(std::list<ModelOpcUa::NodeId_t> nodeIds) override {
+			++NumReads;
+			if (!nodeIds.empty() && Unreadable.count(nodeIds.front())) {
+				throw Umati::Exceptions::UmatiException("BadNodeIdUnknown");
+			}
+			std::vector<nlohmann::json> ret;
+			for (const auto &id : nodeIds) {
+				auto it = Values.find(id);
+				ret.push_back(Unreadable.count(id) || it == Values.end() ? nlohmann::json() : it->second);
+			}
+			return ret;
+		}
+
+		std::list<ModelOpcUa::BrowseResult_t> Browse(ModelOpcUa::NodeId_t, BrowseContext_t) override { return {}; }
+
+		bool isSameOrSubtype(const ModelOpcUa::NodeId_t &, const ModelOpcUa::NodeId_t &, std::size_t) override {
+			return false;
+		}
+
+		std::list<ModelOpcUa::BrowseResult_t>
+		BrowseWithResultTypeFilter(ModelOpcUa::NodeId_t, BrowseContext_t, ModelOpcUa::NodeId_t) override { return {}; }
+
+		ModelOpcUa::NodeId_t TranslateBrowsePathToNodeId(ModelOpcUa::NodeId_t, ModelOpcUa::QualifiedName_t) override {
+			return {};
+		}
+
+		std::string readNodeBrowseName(const ModelOpcUa::NodeId_t &) override { return {}; }
+
+		std::string getTypeName(const ModelOpcUa::NodeId_t &) override { return {}; }
+
+		std::shared_ptr<ValueSubscriptionHandle> Subscribe(ModelOpcUa::NodeId_t, newValueCallbackFunction_t) override {
+			return nullptr;
+		}
+
+		void Unsubscribe(std::vector<int32_t>, std::vector<int32_t>) override {}
+
+		std::vector<std::string> Namespaces() override { return {TestUri}; }
+
+		bool VerifyConnection() override { return true; }
+	};
+
+	class NullPublisher : public Umati::Dashboard::IPublisher {
+	public:
+		void Publish(std::string, std::string) override {}
+	};
+}
+
+namespace Umati {
+	namespace MachineObserver {
+		class TestDashboardMachineObserver : public DashboardMachineObserver {
+		public:
+			TestDashboardMachineObserver(std::shared_ptr<Dashboard::IDashboardDataClient> pDataClient,
+										 std::shared_ptr<Dashboard::OpcUaTypeReader> pTypeReader)
+				: DashboardMachineObserver(std::move(pDataClient), std::make_shared<NullPublisher>(), std::move(pTypeReader), {}) {
+				// The machines are identified by the test only
+				stopMachineUpdateThread();
+			}
+
+			/// Identification nodes as if browsed, without values received by a subscription
+			void addIdentificationNodes(const ModelOpcUa::NodeId_t &machineNodeId, std::list<ModelOpcUa::NodeId_t> nodeIds,
+										std::vector<std::string> keys) {
+				IdentificationNodes_t nodes;
+				nodes.Values.resize(nodeIds.size());
+				nodes.Received.resize(nodeIds.size(), false);
+				nodes.NodeIds = std::move(nodeIds);
+				nodes.Keys = std::move(keys);
+				m_identificationNodes[machineNodeId] = nodes;
+			}
+
+			bool hasIdentificationNodes(const ModelOpcUa::NodeId_t &machineNodeId) const {
+				return m_identificationNodes.count(machineNodeId) != 0;
+			}
+
+			using DashboardMachineObserver::identifyOnlineMachines;
+		};
+	}
+}
+
+class DashboardMachineObserver_identifyOnlineMachines : public ::testing::Test {
+protected:
+	void SetUp() override {
+		m_pClient = std::make_shared<FakeDataClient>();
+		auto pTypeReader = std::make_shared<Umati::Dashboard::OpcUaTypeReader>(
+			m_pClient, std::vector<std::string>{TestUri}, std::vector<Umati::Util::NamespaceInformation>{});
+		ModelOpcUa::BrowseResult_t type;
+		type.NodeClass = ModelOpcUa::ObjectType;
+		type.NodeId = m_type;
+		type.BrowseName = ModelOpcUa::QualifiedName_t{TestUri, "MachineType"};
+		pTypeReader->m_typeMap->insert(std::make_pair(m_type, std::make_shared<ModelOpcUa::StructureNode>(type, false)));
+		m_pObserver = std::make_shared<Umati::MachineObserver::TestDashboardMachineObserver>(m_pClient, pTypeReader);
+	}
+
+	/// Machine with a SerialNumber and a Manufacturer, readable and with values unless offline
+	ModelOpcUa::BrowseResult_t addMachine(const std::string &name, bool online) {
+		ModelOpcUa::BrowseResult_t machine;
+		machine.NodeClass = ModelOpcUa::Object;
+		machine.NodeId = nodeId("s=" + name);
+		machine.TypeDefinition = m_type;
+		machine.BrowseName = ModelOpcUa::QualifiedName_t{TestUri, name};
+		auto serialNumber = nodeId("s=" + name + ".SerialNumber");
+		auto manufacturer = nodeId("s=" + name + ".Manufacturer");
+		m_pObserver->addIdentificationNodes(machine.NodeId, {serialNumber, manufacturer}, {"SerialNumber", "Manufacturer"});
+		if (online) {
+			m_pClient->Values[serialNumber] = name + "-0001";
+			m_pClient->Values[manufacturer] = "umati";
+		} else {
+			m_pClient->Unreadable.insert(serialNumber);
+			m_pClient->Unreadable.insert(manufacturer);
+		}
+		return machine;
+	}
+
+	const ModelOpcUa::NodeId_t m_type = nodeId("i=1000");
+	std::shared_ptr<FakeDataClient> m_pClient;
+	std::shared_ptr<Umati::MachineObserver::TestDashboardMachineObserver> m_pObserver;
+};
+
+TEST_F(DashboardMachineObserver_identifyOnlineMachines, offlineMachinesInBatchAreSkipped) {
+	auto machineA = addMachine("A", true);
+	auto machineB = addMachine("B", false);
+	auto machineC = addMachine("C", true);
+
+	auto identifications = m_pObserver->identifyOnlineMachines({machineA, machineB, machineC});
+
+	// The first node is readable, all machines are read at once and B only gets null values
+	EXPECT_EQ(m_pClient->NumReads, 1u);
+	ASSERT_EQ(identifications.size(), 2u);
+	EXPECT_EQ(identifications.at(machineA.NodeId)["Data"]["SerialNumber"], "A-0001");
+	EXPECT_EQ(identifications.at(machineC.NodeId)["Data"]["SerialNumber"], "C-0001");
+	EXPECT_EQ(identifications.count(machineB.NodeId), 0u);
+	EXPECT_FALSE(m_pObserver->hasIdentificationNodes(machineB.NodeId));
+	EXPECT_TRUE(m_pObserver->hasIdentificationNodes(machineA.NodeId));
+}
+
+TEST_F(DashboardMachineObserver_identifyOnlineMachines, failedBatchIsReadMachineByMachine) {
+	auto machineB = addMachine("B", false);
+	auto machineA = addMachine("A", true);
+
+	auto identifications = m_pObserver->identifyOnlineMachines({machineB, machineA});
+
+	// The batch fails on B's first node, then each machine is read on its own
+	EXPECT_EQ(m_pClient->NumReads, 3u);
+	ASSERT_EQ(identifications.size(), 1u);
+	EXPECT_EQ(identifications.at(machineA.NodeId)["Data"]["Manufacturer"], "umati");
+	EXPECT_FALSE(m_pObserver->hasIdentificationNodes(machineB.NodeId));
+}
+
+TEST_F(DashboardMachineObserver_identifyOnlineMachines, allMachinesOffline) {
+	auto machineA = addMachine("A", true);
+	auto machineB = addMachine("B", false);
+	m_pClient->Unreadable.insert(nodeId("s=A.SerialNumber"));
+	m_pClient->Unreadable.insert(nodeId("s=A.Manufacturer"));
+
+	auto identifications = m_pObserver->identifyOnlineMachines({machineA, machineB});
+
+	EXPECT_TRUE(identifications.empty());
+	EXPECT_FALSE(m_pObserver->hasIdentificationNodes(machineA.NodeId));
+	EXPECT_FALSE(m_pObserver->hasIdentificationNodes(machineB.NodeId));
+}
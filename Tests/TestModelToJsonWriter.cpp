@@ -0,0 +1,207 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <gtest/gtest.h>
+
+#include <Converter/ModelToJson.hpp>
+#include <Converter/ModelToJsonWriter.hpp>
+#include <JsonFormat.hpp>
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+using Umati::Dashboard::Converter::ModelToJson;
+using Umati::Dashboard::Converter::ModelToJsonWriter;
+
+namespace {
+	const std::string TestUri = "http://example.com/machine/";
+	const ModelOpcUa::NodeId_t BaseDataVariableType{"", "i=63"};
+	const ModelOpcUa::NodeId_t PropertyType{"", "i=68"};
+	const ModelOpcUa::NodeId_t FolderType{"", "i=61"};
+
+	typedef std::list<std::shared_ptr<const ModelOpcUa::Node>> Children_t;
+
+	/// Builds node trees and holds the values of their variables by value slot
+	class Model {
+	public:
+		std::shared_ptr<const ModelOpcUa::Node> object(const std::string &name, Children_t children,
+														ModelOpcUa::ModellingRule_t rule = ModelOpcUa::Mandatory) {
+			return std::make_shared<ModelOpcUa::SimpleNode>(
+				nodeId(name), FolderType, definition(ModelOpcUa::Object, rule, FolderType, name), children);
+		}
+
+		std::shared_ptr<const ModelOpcUa::Node> variable(const std::string &name, nlohmann::json value,
+														  const ModelOpcUa::NodeId_t &type = PropertyType,
+														  Children_t children = {}) {
+			auto pNode = std::make_shared<ModelOpcUa::SimpleNode>(
+				nodeId(name), type, definition(ModelOpcUa::Variable, ModelOpcUa::Mandatory, type, name), children);
+			pNode->ValueSlot = Values.size();
+			Values.push_back(std::move(value));
+			return pNode;
+		}
+
+		/// elements are pairs of BrowseName and node
+		std::shared_ptr<const ModelOpcUa::Node> placeholder(
+			const std::string &name,
+			const std::vector<std::pair<std::string, std::shared_ptr<const ModelOpcUa::Node>>> &elements) {
+			auto pNode = std::make_shared<ModelOpcUa::PlaceholderNode>(
+				definition(ModelOpcUa::Object, ModelOpcUa::OptionalPlaceholder, FolderType, name), Children_t{});
+			for (const auto &element : elements) {
+				ModelOpcUa::PlaceholderElement placeholderElement;
+				placeholderElement.pNode = std::dynamic_pointer_cast<const ModelOpcUa::SimpleNode>(element.second);
+				placeholderElement.BrowseName = ModelOpcUa::QualifiedName_t{TestUri, element.first};
+				placeholderElement.TypeDefinition = ModelOpcUa::NodeId_t{TestUri, "i=1002"};
+				pNode->addInstance(placeholderElement);
+			}
+			return pNode;
+		}
+
+		/// Document as published without the writer
+		std::string modelToJson(const std::shared_ptr<const ModelOpcUa::Node> &pNode) const {
+			auto getValue = [this](const std::shared_ptr<const ModelOpcUa::SimpleNode> &pSimpleNode) -> nlohmann::json {
+				return pSimpleNode->ValueSlot < Values.size() ? Values[pSimpleNode->ValueSlot] : nlohmann::json();
+			};
+			return Umati::Util::JsonFormat::Dump(ModelToJson(pNode, getValue).getJson());
+		}
+
+		/// Document as streamed by the writer, false if the writer falls back to ModelToJson
+		bool write(const std::shared_ptr<const ModelOpcUa::Node> &pNode, std::string &out) const {
+			std::vector<std::shared_ptr<const std::string>> fragments;
+			for (const auto &value : Values) {
+				fragments.push_back(ModelToJsonWriter::fragment(value));
+			}
+			auto getFragment = [&fragments](std::size_t valueSlot) -> std::shared_ptr<const std::string> {
+				return valueSlot < fragments.size() ? fragments[valueSlot] : nullptr;
+			};
+			return ModelToJsonWriter(pNode).write(getFragment, out);
+		}
+
+		std::vector<nlohmann::json> Values;
+
+	private:
+		static ModelOpcUa::NodeId_t nodeId(const std::string &name) { return ModelOpcUa::NodeId_t{TestUri, "s=" + name}; }
+
+		static ModelOpcUa::NodeDefinition definition(ModelOpcUa::NodeClass_t nodeClass, ModelOpcUa::ModellingRule_t rule,
+													 const ModelOpcUa::NodeId_t &type, const std::string &name) {
+			return ModelOpcUa::NodeDefinition(nodeClass, rule, ModelOpcUa::NodeId_t{"", "i=47"}, type,
+											  ModelOpcUa::QualifiedName_t{TestUri, name});
+		}
+	};
+
+	/// Runs the test body with pretty and compact output
+	class ModelToJsonWriterTest : public ::testing::TestWithParam<bool> {
+	protected:
+		void SetUp() override {
+			m_compact = Umati::Util::JsonFormat::Compact;
+			Umati::Util::JsonFormat::Compact = GetParam();
+		}
+
+		void TearDown() override { Umati::Util::JsonFormat::Compact = m_compact; }
+
+		void expectSameDocument(const Model &model, const std::shared_ptr<const ModelOpcUa::Node> &pNode) {
+			std::string streamed;
+			ASSERT_TRUE(model.write(pNode, streamed));
+			EXPECT_EQ(streamed, model.modelToJson(pNode));
+		}
+
+	private:
+		bool m_compact = false;
+	};
+}
+
+TEST_P(ModelToJsonWriterTest, machine) {
+	Model model;
+	auto pMachine = model.object("Machine", {
+		model.object("Identification", {
+			model.variable("Manufacturer", "umati \"sample\" manufacturer"),
+			model.variable("SerialNumber", "0815"),
+			model.variable("YearOfConstruction", 2021),
+			// Null values are left out
+			model.variable("Location", nullptr),
+		}),
+		model.object("Monitoring", {
+			model.variable("Temperature", 21.5, BaseDataVariableType, {
+				model.variable("EngineeringUnits", {{"DisplayName", "°C"}, {"UnitId", 4408652}}),
+				model.variable("EURange", {{"low", -20.0}, {"high", 120.0}}),
+			}),
+			model.variable("Curve", {{1, 2, 3}, {4, 5, 6}}),
+			model.variable("Flags", {true, false, true}),
+			model.variable("EmptyArray", nlohmann::json::array()),
+		}),
+		// An object without values is left out
+		model.object("Empty", {model.variable("Nothing", nullptr)}),
+	});
+	expectSameDocument(model, pMachine);
+}
+
+TEST_P(ModelToJsonWriterTest, placeholders) {
+	Model model;
+	auto pMachine = model.object("Machine", {
+		model.placeholder("Tools", {
+			{"Tool2", model.object("Tool2", {model.variable("Name", "Drill")})},
+			{"Tool1", model.object("Tool1", {model.variable("Name", "Mill"), model.variable("Wear", 0.25)})},
+			// Only the $TypeDefinition of elements without values is written
+			{"Tool3", model.object("Tool3", {model.variable("Name", nullptr)})},
+			// Later elements with the same BrowseName replace earlier ones
+			{"Tool1", model.object("Tool1", {model.variable("Name", "Replaced")})},
+		}),
+		model.placeholder("NoElements", {}),
+	});
+	expectSameDocument(model, pMachine);
+}
+
+TEST_P(ModelToJsonWriterTest, duplicateBrowseNames) {
+	Model model;
+	auto pMachine = model.object("Machine", {
+		model.variable("State", "Running"),
+		model.variable("State", "Stopped"),
+		// The last child that is not null wins
+		model.variable("Mode", "Auto"),
+		model.variable("Mode", nullptr),
+	});
+	expectSameDocument(model, pMachine);
+}
+
+TEST_P(ModelToJsonWriterTest, nullDocument) {
+	Model model;
+	auto pMachine = model.object("Machine", {model.variable("Name", nullptr)});
+	std::string streamed;
+	ASSERT_TRUE(model.write(pMachine, streamed));
+	EXPECT_EQ(streamed, "null");
+	EXPECT_EQ(streamed, model.modelToJson(pMachine));
+}
+
+TEST_P(ModelToJsonWriterTest, fallbackForStructureElements) {
+	Model model;
+	// ModelToJson adds the $TypeDefinition to the value itself, the writer can not stream that
+	auto pMachine = model.object("Machine", {
+		model.placeholder("Results", {
+			{"Result1", model.variable("Result1", {{"Id", 1}, {"Passed", true}})},
+		}),
+	});
+	std::string streamed = "previous";
+	EXPECT_FALSE(model.write(pMachine, streamed));
+	EXPECT_TRUE(streamed.empty());
+
+	auto document = nlohmann::json::parse(model.modelToJson(pMachine));
+	EXPECT_EQ(document["Results"]["Result1"]["Passed"], true);
+	EXPECT_EQ(document["Results"]["Result1"]["$TypeDefinition"], "nsu=" + TestUri + ";i=1002");
+}
+
+TEST_P(ModelToJsonWriterTest, fallbackForTypeDefinitionChild) {
+	Model model;
+	auto pMachine = model.object("Machine", {
+		model.placeholder("Tools", {
+			{"Tool1", model.object("Tool1", {model.variable("$TypeDefinition", "own value")})},
+		}),
+	});
+	std::string streamed;
+	EXPECT_FALSE(model.write(pMachine, streamed));
+	EXPECT_NO_THROW(nlohmann::json::parse(model.modelToJson(pMachine)));
+}
+
+INSTANTIATE_TEST_SUITE_P(PrettyAndCompact, ModelToJsonWriterTest, ::testing::Values(false, true));
@@ -33,9 +33,8 @@ namespace Umati {
 TEST(Subscription, subscriptionStatusChanged) {
 	Umati::Util::ConfigureLogger("Subscription.subscriptionStatusChanged");
 
-	std::map<std::string, uint16_t> uriToIndexCache;
-	std::map<uint16_t, std::string> indexToUriCache;
-	Umati::OpcUa::Subscription subscription(uriToIndexCache, indexToUriCache);
+	Umati::OpcUa::NamespaceCache namespaceCache;
+	Umati::OpcUa::Subscription subscription(namespaceCache);
 	subscription.subscriptionStatusChanged(1, OpcUa_Good);
 }
 
@@ -49,9 +48,8 @@ TEST(Subscription, createSubscription) {
 	Umati::OpcUa::MockOpcUaSubscriptionWrapper mockOpcUaSubscriptionWrapper;
 	UaStatus uaStatus1(OpcUa_Good);
 	EXPECT_CALL(mockOpcUaSubscriptionWrapper, SessionCreateSubscription).Times(1).WillOnce(Return(uaStatus1));
-	std::map<std::string, uint16_t> uriToIndexCache;
-	std::map<uint16_t, std::string> indexToUriCache;
-	Umati::OpcUa::Subscription subscription(uriToIndexCache, indexToUriCache);
+	Umati::OpcUa::NamespaceCache namespaceCache;
+	Umati::OpcUa::Subscription subscription(namespaceCache);
 	subscription.setSubscriptionWrapper(&mockOpcUaSubscriptionWrapper);
 	subscription.createSubscription(pMockSession);
 }
@@ -66,9 +64,8 @@ TEST(Subscription, deleteSubscription_mPSubscriptionNull_notCalled) {
 	Umati::OpcUa::MockOpcUaSubscriptionWrapper mockOpcUaSubscriptionWrapper;
 	UaStatus uaStatus1(OpcUa_Good);
 	EXPECT_CALL(mockOpcUaSubscriptionWrapper, SessionDeleteSubscription).Times(0);
-	std::map<std::string, uint16_t> uriToIndexCache;
-	std::map<uint16_t, std::string> indexToUriCache;
-	Umati::OpcUa::Subscription subscription(uriToIndexCache, indexToUriCache);
+	Umati::OpcUa::NamespaceCache namespaceCache;
+	Umati::OpcUa::Subscription subscription(namespaceCache);
 	subscription.setSubscriptionWrapper(&mockOpcUaSubscriptionWrapper);
 	subscription.deleteSubscription(pMockSession);
 }
\ No newline at end of file
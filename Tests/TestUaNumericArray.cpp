@@ -0,0 +1,128 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <gtest/gtest.h>
+
+#include <Converter/UaNumericArray.hpp>
+
+#include <limits>
+#include <vector>
+
+using Umati::OpcUa::Converter::UaNumericArray;
+
+namespace {
+	/// Variant referencing values, with dimensions if not empty
+	template<typename T>
+	UA_Variant arrayVariant(std::vector<T> &values, std::size_t typeIndex, std::vector<UA_UInt32> &dimensions) {
+		UA_Variant variant;
+		UA_Variant_setArray(&variant, values.data(), values.size(), &UA_TYPES[typeIndex]);
+		variant.arrayDimensions = dimensions.empty() ? nullptr : dimensions.data();
+		variant.arrayDimensionsSize = dimensions.size();
+		return variant;
+	}
+
+	template<typename T>
+	nlohmann::json convert(std::vector<T> values, std::size_t typeIndex, std::vector<UA_UInt32> dimensions = {}) {
+		auto variant = arrayVariant(values, typeIndex, dimensions);
+		nlohmann::json jsonValue;
+		EXPECT_TRUE(UaNumericArray::toJson(variant, jsonValue));
+		return jsonValue;
+	}
+}
+
+TEST(UaNumericArray, booleans) {
+	// UA_Boolean is bool, std::vector<UA_Boolean> has no contiguous data
+	UA_Boolean flags[] = {true, false, true};
+	UA_Variant variant;
+	UA_Variant_setArray(&variant, flags, 3, &UA_TYPES[UA_TYPES_BOOLEAN]);
+	nlohmann::json jsonValue;
+	ASSERT_TRUE(UaNumericArray::toJson(variant, jsonValue));
+	EXPECT_EQ(jsonValue, nlohmann::json({true, false, true}));
+	EXPECT_TRUE(jsonValue[0].is_boolean());
+}
+
+TEST(UaNumericArray, integers) {
+	EXPECT_EQ(convert<UA_SByte>({-128, 0, 127}, UA_TYPES_SBYTE), nlohmann::json({-128, 0, 127}));
+	EXPECT_EQ(convert<UA_Byte>({0, 255}, UA_TYPES_BYTE), nlohmann::json({0, 255}));
+	EXPECT_EQ(convert<UA_Int16>({-32768, 32767}, UA_TYPES_INT16), nlohmann::json({-32768, 32767}));
+	EXPECT_EQ(convert<UA_UInt16>({65535}, UA_TYPES_UINT16), nlohmann::json({65535}));
+	EXPECT_EQ(convert<UA_Int32>({std::numeric_limits<UA_Int32>::min(), 42}, UA_TYPES_INT32),
+			  nlohmann::json({std::numeric_limits<UA_Int32>::min(), 42}));
+	EXPECT_EQ(convert<UA_UInt32>({std::numeric_limits<UA_UInt32>::max()}, UA_TYPES_UINT32),
+			  nlohmann::json({std::numeric_limits<UA_UInt32>::max()}));
+	EXPECT_EQ(convert<UA_Int64>({std::numeric_limits<UA_Int64>::min()}, UA_TYPES_INT64),
+			  nlohmann::json({std::numeric_limits<UA_Int64>::min()}));
+	EXPECT_EQ(convert<UA_UInt64>({std::numeric_limits<UA_UInt64>::max()}, UA_TYPES_UINT64),
+			  nlohmann::json({std::numeric_limits<UA_UInt64>::max()}));
+}
+
+TEST(UaNumericArray, bytesAreNumbers) {
+	// Written as numbers, not as characters or a binary value
+	auto jsonValue = convert<UA_Byte>({65, 66}, UA_TYPES_BYTE);
+	EXPECT_EQ(jsonValue.dump(), "[65,66]");
+}
+
+TEST(UaNumericArray, floatingPoint) {
+	EXPECT_EQ(convert<UA_Float>({0.5f, -1.25f}, UA_TYPES_FLOAT), nlohmann::json({0.5, -1.25}));
+	EXPECT_EQ(convert<UA_Double>({21.5, -0.125, 1e300}, UA_TYPES_DOUBLE), nlohmann::json({21.5, -0.125, 1e300}));
+}
+
+TEST(UaNumericArray, multiDimensionalRowMajor) {
+	auto matrix = convert<UA_Int32>({1, 2, 3, 4, 5, 6}, UA_TYPES_INT32, {2, 3});
+	EXPECT_EQ(matrix, nlohmann::json({{1, 2, 3}, {4, 5, 6}}));
+
+	auto transposed = convert<UA_Int32>({1, 2, 3, 4, 5, 6}, UA_TYPES_INT32, {3, 2});
+	EXPECT_EQ(transposed, nlohmann::json({{1, 2}, {3, 4}, {5, 6}}));
+
+	auto cube = convert<UA_Double>({1, 2, 3, 4, 5, 6, 7, 8}, UA_TYPES_DOUBLE, {2, 2, 2});
+	EXPECT_EQ(cube, nlohmann::json({{{1.0, 2.0}, {3.0, 4.0}}, {{5.0, 6.0}, {7.0, 8.0}}}));
+}
+
+TEST(UaNumericArray, singleEntryDimensions) {
+	EXPECT_EQ(convert<UA_Int16>({7, 8}, UA_TYPES_INT16, {2}), nlohmann::json({7, 8}));
+	EXPECT_EQ(convert<UA_Int16>({7, 8}, UA_TYPES_INT16, {1, 2}), nlohmann::json({{7, 8}}));
+	EXPECT_EQ(convert<UA_Int16>({7, 8}, UA_TYPES_INT16, {2, 1}), nlohmann::json({{7}, {8}}));
+}
+
+TEST(UaNumericArray, mismatchedDimensionsAreOneDimensional) {
+	// Too few and too many elements for the dimensions
+	EXPECT_EQ(convert<UA_UInt32>({1, 2, 3, 4, 5}, UA_TYPES_UINT32, {2, 3}), nlohmann::json({1, 2, 3, 4, 5}));
+	EXPECT_EQ(convert<UA_UInt32>({1, 2, 3, 4}, UA_TYPES_UINT32, {1, 3}), nlohmann::json({1, 2, 3, 4}));
+	EXPECT_EQ(convert<UA_UInt32>({1, 2}, UA_TYPES_UINT32, {0, 2}), nlohmann::json({1, 2}));
+}
+
+TEST(UaNumericArray, overflowingDimensionsAreOneDimensional) {
+	// 111620 * 429509837 * 384773 = 2^64 + 4, a 64 bit product wraps around to the number of elements
+	EXPECT_EQ(convert<UA_Byte>({1, 2, 3, 4}, UA_TYPES_BYTE, {111620, 429509837, 384773}), nlohmann::json({1, 2, 3, 4}));
+}
+
+TEST(UaNumericArray, emptyArrays) {
+	std::vector<UA_Double> empty;
+	std::vector<UA_UInt32> noDimensions;
+	auto variant = arrayVariant(empty, UA_TYPES_DOUBLE, noDimensions);
+	nlohmann::json jsonValue = "previous";
+	EXPECT_TRUE(UaNumericArray::toJson(variant, jsonValue));
+	EXPECT_EQ(jsonValue, "previous");
+
+	std::vector<UA_UInt32> zeroDimensions = {0, 3};
+	variant = arrayVariant(empty, UA_TYPES_DOUBLE, zeroDimensions);
+	nlohmann::json nullValue;
+	EXPECT_TRUE(UaNumericArray::toJson(variant, nullValue));
+	EXPECT_TRUE(nullValue.is_null());
+}
+
+TEST(UaNumericArray, unsupportedTypes) {
+	EXPECT_FALSE(UaNumericArray::isSupported(nullptr));
+	EXPECT_FALSE(UaNumericArray::isSupported(&UA_TYPES[UA_TYPES_STRING]));
+	EXPECT_TRUE(UaNumericArray::isSupported(&UA_TYPES[UA_TYPES_BOOLEAN]));
+	EXPECT_TRUE(UaNumericArray::isSupported(&UA_TYPES[UA_TYPES_DOUBLE]));
+
+	std::vector<UA_String> strings(2);
+	std::vector<UA_UInt32> noDimensions;
+	auto variant = arrayVariant(strings, UA_TYPES_STRING, noDimensions);
+	nlohmann::json jsonValue = "previous";
+	EXPECT_FALSE(UaNumericArray::toJson(variant, jsonValue));
+	EXPECT_EQ(jsonValue, "previous");
+}
@@ -0,0 +1,96 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <gtest/gtest.h>
+
+#include <Converter/UaValueFormat.hpp>
+
+#include <cstddef>
+#include <initializer_list>
+#include <limits>
+#include <string>
+
+using Umati::OpcUa::Converter::UaValueFormat;
+
+namespace {
+	const UA_DateTime TicksPerDay = 24LL * 60 * 60 * 1000 * UA_DATETIME_MSEC;
+
+	/// Checks that writeDateTime and dateTimeToString agree and stay within MaxDateTimeLength
+	std::string format(UA_DateTime dateTime) {
+		char buffer[UaValueFormat::MaxDateTimeLength];
+		auto length = UaValueFormat::writeDateTime(dateTime, buffer);
+		const std::size_t maxLength = UaValueFormat::MaxDateTimeLength;
+		EXPECT_LE(length, maxLength);
+		std::string written(buffer, length);
+		EXPECT_EQ(written, UaValueFormat::dateTimeToString(dateTime));
+		return written;
+	}
+
+	UA_Guid guid(UA_UInt32 data1, UA_UInt16 data2, UA_UInt16 data3, std::initializer_list<UA_Byte> data4) {
+		UA_Guid ret;
+		ret.data1 = data1;
+		ret.data2 = data2;
+		ret.data3 = data3;
+		std::size_t i = 0;
+		for (auto byte : data4) {
+			ret.data4[i++] = byte;
+		}
+		return ret;
+	}
+}
+
+TEST(UaValueFormat, dateTimeEpochs) {
+	EXPECT_EQ(format(0), "1601-01-01T00:00:00.000Z");
+	EXPECT_EQ(format(UA_DATETIME_UNIX_EPOCH), "1970-01-01T00:00:00.000Z");
+}
+
+TEST(UaValueFormat, dateTimeMilliseconds) {
+	EXPECT_EQ(format(132274551090420000LL), "2020-02-29T13:05:09.042Z");
+	// Fractions of a millisecond are cut off, also before 1970 and before 1601
+	EXPECT_EQ(format(UA_DATETIME_UNIX_EPOCH - 5000), "1969-12-31T23:59:59.999Z");
+	EXPECT_EQ(format(UA_DATETIME_UNIX_EPOCH + 9999), "1970-01-01T00:00:00.000Z");
+	EXPECT_EQ(format(-1), "1600-12-31T23:59:59.999Z");
+}
+
+TEST(UaValueFormat, dateTimeLeapDays) {
+	const UA_DateTime march1st2000 = 125963424000000000LL;
+	EXPECT_EQ(format(march1st2000), "2000-03-01T00:00:00.000Z");
+	EXPECT_EQ(format(march1st2000 - TicksPerDay), "2000-02-29T00:00:00.000Z");
+	const UA_DateTime march1st1900 = 94405824000000000LL;
+	EXPECT_EQ(format(march1st1900), "1900-03-01T00:00:00.000Z");
+	EXPECT_EQ(format(march1st1900 - TicksPerDay), "1900-02-28T00:00:00.000Z");
+}
+
+TEST(UaValueFormat, dateTimeFourDigitYearBoundaries) {
+	const UA_DateTime year0 = -505227456000000000LL;
+	EXPECT_EQ(format(year0), "0000-01-01T00:00:00.000Z");
+	EXPECT_EQ(format(year0 - 1), "-0001-12-31T23:59:59.999Z");
+	const UA_DateTime year10000 = 2650467744000000000LL;
+	EXPECT_EQ(format(year10000 - 1), "9999-12-31T23:59:59.999Z");
+	EXPECT_EQ(format(year10000), "10000-01-01T00:00:00.000Z");
+}
+
+TEST(UaValueFormat, dateTimeLimits) {
+	EXPECT_EQ(format(std::numeric_limits<UA_DateTime>::min()), "-27627-04-19T21:11:54.522Z");
+	EXPECT_EQ(format(std::numeric_limits<UA_DateTime>::max()), "30828-09-14T02:48:05.477Z");
+}
+
+TEST(UaValueFormat, guid) {
+	EXPECT_EQ(UaValueFormat::guidToString(guid(0x72962b91, 0xfa75, 0x4ae6, {0x8d, 0x28, 0xb4, 0x04, 0xdc, 0x7d, 0xaf, 0x63})),
+			  "72962b91-fa75-4ae6-8d28-b404dc7daf63");
+}
+
+TEST(UaValueFormat, guidLeadingZeros) {
+	EXPECT_EQ(UaValueFormat::guidToString(guid(0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0})),
+			  "00000000-0000-0000-0000-000000000000");
+	EXPECT_EQ(UaValueFormat::guidToString(guid(0x1, 0x2, 0x3, {0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xa, 0xb})),
+			  "00000001-0002-0003-0405-060708090a0b");
+}
+
+TEST(UaValueFormat, guidLargestValues) {
+	char buffer[UaValueFormat::GuidLength];
+	UaValueFormat::writeGuid(guid(0xffffffff, 0xffff, 0xffff, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}), buffer);
+	EXPECT_EQ(std::string(buffer, UaValueFormat::GuidLength), "ffffffff-ffff-ffff-ffff-ffffffffffff");
+}
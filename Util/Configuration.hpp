@@ -26,6 +26,17 @@ namespace Umati {
 			std::string Prefix = "umati";
 			std::string ClientId = "umati";
 			std::string Protocol = "tcp";
+			/// Publish JSON payloads without indentation and line breaks
+			bool CompactJson = false;
+			/// Publish RFC 7386 merge patches of each machine document on Topics::MachinePatch instead of the full
+			/// document. The full document is only published for new machines and every 10 s, subscribers have to
+			/// apply the patches in between.
+			bool PublishPatches = false;
+			/// Number of topics waiting to be sent above which a warning is logged. It does not bound the queue: only
+			/// the latest message of a topic is queued, so it holds at most one message per topic and none is dropped.
+			std::uint32_t PublishQueueWarnSize = 10000;
+			/// Minimum time in ms between two publishes triggered by value changes
+			std::uint32_t PublishMinInterval = 10;
 		};
 
 		struct OpcUaConfig {
@@ -36,6 +47,21 @@ namespace Umati {
 			/// 1 = None, 2 Sign, 3 = Sign&Encrypt
 			std::uint8_t Security = 1;
 			bool ByPassCertVerification = false;
+			/// Maximum number of references per node and Browse/BrowseNext call, 0 = decided by the server
+			std::uint32_t BrowsePageSize = 1000;
+			/// Maximum number of monitored items per CreateMonitoredItems call, further capped by the server's limit. 0 = decided by the server
+			std::uint32_t MaxMonitoredItemsPerCall = 500;
+			/// Number of machine models built concurrently when new machines are found, 1 = one after another.
+			/// All builds share one session, the requests resolving their models are pipelined on it.
+			std::uint32_t MaxParallelMachineBuilds = 4;
+			/// File to store the browsed types in, reused while the server's NamespaceMetadata is unchanged. Empty = always browse types
+			std::string TypeCacheFile;
+			/// Seconds between full searches for machines if the server reports model changes by events
+			std::uint32_t MachineFullUpdateInterval = 300;
+			/// Maximum number of types whose supertype is cached, the cache is kept across resets
+			std::uint32_t SuperTypeCacheSize = 10000;
+			/// Browse the supertypes of all object and variable types at once after reading the types
+			bool PrefetchSuperTypes = false;
 		};
 
 		/**
@@ -17,8 +17,8 @@ namespace ModelOpcUa
 }
 namespace Umati {
 	namespace Util {
-		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(MqttConfig, Hostname, Port, Username, Password, Prefix, ClientId, Protocol);
-		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(OpcUaConfig, Endpoint, Username, Password, Security, ByPassCertVerification);
+		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(MqttConfig, Hostname, Port, Username, Password, Prefix, ClientId, Protocol, CompactJson, PublishPatches, PublishQueueWarnSize, PublishMinInterval);
+		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(OpcUaConfig, Endpoint, Username, Password, Security, ByPassCertVerification, BrowsePageSize, MaxMonitoredItemsPerCall, MaxParallelMachineBuilds, TypeCacheFile, MachineFullUpdateInterval, SuperTypeCacheSize, PrefetchSuperTypes);
 		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(NamespaceInformation, Namespace, Types, IdentificationType);
 
 		class ConfigurationJsonFile : public Configuration {
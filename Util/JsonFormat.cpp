@@ -0,0 +1,20 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "JsonFormat.hpp"
+
+namespace Umati
+{
+    namespace Util
+    {
+        bool JsonFormat::Compact = false;
+
+        std::string JsonFormat::Dump(const nlohmann::json &value, int prettyIndent)
+        {
+            // An indent of -1 selects the compact representation
+            return value.dump(Compact ? -1 : prettyIndent);
+        }
+    } // namespace Util
+} // namespace Umati
@@ -0,0 +1,22 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace Umati {
+    namespace Util {
+        /// Serialization of published JSON payloads
+        class JsonFormat {
+        public:
+            /// Set from MqttConfig::CompactJson, omits all whitespace when true
+            static bool Compact;
+
+            /// Serialize value, prettyIndent is only used when Compact is false
+            static std::string Dump(const nlohmann::json &value, int prettyIndent = 2);
+        };
+    }
+}
@@ -0,0 +1,130 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "Scheduler.hpp"
+
+#include <easylogging++.h>
+
+namespace Umati
+{
+    namespace Util
+    {
+        Scheduler::~Scheduler()
+        {
+            stop();
+        }
+
+        Scheduler::TaskId_t Scheduler::addPeriodic(std::chrono::milliseconds interval, std::function<void()> task,
+                                                   std::chrono::milliseconds minTriggerInterval)
+        {
+            std::lock_guard<decltype(m_mutex)> l(m_mutex);
+            Task_t newTask;
+            newTask.interval = interval;
+            newTask.minTriggerInterval = minTriggerInterval;
+            newTask.task = std::move(task);
+            m_tasks.push_back(std::move(newTask));
+            auto taskId = m_tasks.size() - 1;
+            schedule(taskId, Clock_t::now() + interval);
+            return taskId;
+        }
+
+        void Scheduler::trigger(TaskId_t taskId)
+        {
+            {
+                std::lock_guard<decltype(m_mutex)> l(m_mutex);
+                auto &task = m_tasks.at(taskId);
+                if (task.running)
+                {
+                    task.triggeredWhileRunning = true;
+                    return;
+                }
+                auto earliest = std::max(Clock_t::now(), task.lastStart + task.minTriggerInterval);
+                if (task.deadline <= earliest)
+                {
+                    // Already due or triggered
+                    return;
+                }
+                schedule(taskId, earliest);
+            }
+            m_condition.notify_one();
+        }
+
+        void Scheduler::start()
+        {
+            std::lock_guard<decltype(m_mutex)> l(m_mutex);
+            if (m_running)
+            {
+                return;
+            }
+            m_running = true;
+            m_workerThread = std::thread([this]() { this->workerThread(); });
+        }
+
+        void Scheduler::stop()
+        {
+            {
+                std::lock_guard<decltype(m_mutex)> l(m_mutex);
+                m_running = false;
+            }
+            m_condition.notify_all();
+            if (m_workerThread.joinable())
+            {
+                m_workerThread.join();
+            }
+        }
+
+        void Scheduler::schedule(TaskId_t taskId, Clock_t::time_point deadline)
+        {
+            m_tasks[taskId].deadline = deadline;
+            m_deadlines.push({deadline, taskId});
+        }
+
+        void Scheduler::workerThread()
+        {
+            std::unique_lock<decltype(m_mutex)> ul(m_mutex);
+            while (m_running)
+            {
+                if (m_deadlines.empty())
+                {
+                    m_condition.wait(ul);
+                    continue;
+                }
+
+                auto next = m_deadlines.top();
+                if (next.deadline != m_tasks[next.taskId].deadline)
+                {
+                    // Outdated by a trigger
+                    m_deadlines.pop();
+                    continue;
+                }
+                if (Clock_t::now() < next.deadline)
+                {
+                    m_condition.wait_until(ul, next.deadline);
+                    continue;
+                }
+                m_deadlines.pop();
+
+                auto &task = m_tasks[next.taskId];
+                task.running = true;
+                task.triggeredWhileRunning = false;
+                task.lastStart = Clock_t::now();
+                ul.unlock();
+                try
+                {
+                    task.task();
+                }
+                catch (std::exception &ex)
+                {
+                    LOG(ERROR) << "Scheduled task failed: " << ex.what();
+                }
+                ul.lock();
+                task.running = false;
+                schedule(next.taskId, task.triggeredWhileRunning
+                                          ? std::max(Clock_t::now(), task.lastStart + task.minTriggerInterval)
+                                          : task.lastStart + task.interval);
+            }
+        }
+    } // namespace Util
+} // namespace Umati
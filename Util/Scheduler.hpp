@@ -0,0 +1,74 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Umati {
+    namespace Util {
+        /**
+         * Runs periodic tasks on one worker thread.
+         * Deadlines are kept in a priority queue, the worker sleeps until the earliest deadline or until a task is triggered.
+         */
+        class Scheduler {
+        public:
+            typedef std::size_t TaskId_t;
+            typedef std::chrono::steady_clock Clock_t;
+
+            ~Scheduler();
+
+            /// Add a task that runs every interval, must be called before start()
+            /// A triggered run starts at the earliest minTriggerInterval after the start of the previous run.
+            TaskId_t addPeriodic(std::chrono::milliseconds interval, std::function<void()> task,
+                                 std::chrono::milliseconds minTriggerInterval = std::chrono::milliseconds(0));
+
+            /// Run the task as soon as possible, multiple triggers before the run are coalesced
+            void trigger(TaskId_t taskId);
+
+            void start();
+
+            /// Waits for a running task to finish
+            void stop();
+
+        protected:
+            struct Task_t {
+                std::chrono::milliseconds interval;
+                std::chrono::milliseconds minTriggerInterval;
+                std::function<void()> task;
+                Clock_t::time_point deadline;
+                Clock_t::time_point lastStart;
+                bool running = false;
+                bool triggeredWhileRunning = false;
+            };
+
+            struct Deadline_t {
+                Clock_t::time_point deadline;
+                TaskId_t taskId;
+
+                bool operator>(const Deadline_t &other) const {
+                    return deadline > other.deadline;
+                }
+            };
+
+            void schedule(TaskId_t taskId, Clock_t::time_point deadline);
+
+            void workerThread();
+
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+            std::vector<Task_t> m_tasks;
+            /// Might contain outdated entries, only entries matching Task_t::deadline are executed
+            std::priority_queue<Deadline_t, std::vector<Deadline_t>, std::greater<Deadline_t>> m_deadlines;
+            bool m_running = false;
+            std::thread m_workerThread;
+        };
+    }
+}